@@ -0,0 +1,228 @@
+//go:build linux
+// +build linux
+
+// Scripted fake devices on a SocketCAN interface, for running the Phoenix stack of the socketcan build against a vcan
+// bus instead of real hardware. It answers as the given Talons, plays back an optional script of frames and reports
+// how many frames per second the robot side manages to put on the bus.
+//
+//	sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+//	go run go-frc/cmd/canbus -iface vcan0 -talons 1,6
+//	go build -tags sim,socketcan -o build/Simulation go-frc
+//
+// A script has one frame per line as "<milliseconds> <arbitration ID> <data>" in hex, for example "20 2041401 00ff".
+package main
+
+import (
+	"bufio"
+	"encoding/binary"
+	"encoding/hex"
+	"flag"
+	"fmt"
+	"net"
+	"os"
+	"strconv"
+	"strings"
+	"sync/atomic"
+	"syscall"
+	"time"
+	"unsafe"
+)
+
+const (
+	canRaw     = 1
+	effFlag    = 0x80000000
+	effMask    = 0x1FFFFFFF
+	deviceMask = 0x3F
+
+	// Talon SRX frame IDs before the device number is added
+	talonControl  = 0x02040080
+	talonStatus1  = 0x02041400
+	talonStatus2  = 0x02041440
+	canFrameBytes = 16
+)
+
+type sockaddrCAN struct {
+	family  uint16
+	_       [2]byte
+	ifindex int32
+	_       [16]byte
+}
+
+type frame struct {
+	id   uint32
+	data []byte
+}
+
+type scriptLine struct {
+	at time.Duration
+	frame
+}
+
+var (
+	ifaceFlag  = flag.String("iface", "vcan0", "SocketCAN interface")
+	talonsFlag = flag.String("talons", "", "comma separated Talon SRX device numbers to answer as")
+	statusFlag = flag.Duration("status", 10*time.Millisecond, "period of the fake Talon status frames")
+	scriptFlag = flag.String("script", "", "file of frames to send")
+	loopFlag   = flag.Bool("loop", false, "repeat the script forever")
+	floodFlag  = flag.Int("flood", 0, "send this many frames as fast as possible and report the rate")
+)
+
+var (
+	received, sent, controls uint64
+)
+
+func main() {
+	flag.Parse()
+	fd, err := openBus(*ifaceFlag)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+	if *floodFlag > 0 {
+		flood(fd, *floodFlag)
+		return
+	}
+
+	talons := make(map[uint32]bool)
+	for _, field := range strings.Split(*talonsFlag, ",") {
+		if field = strings.TrimSpace(field); field != "" {
+			device, err := strconv.ParseUint(field, 10, 6)
+			if err != nil {
+				fmt.Fprintln(os.Stderr, err)
+				os.Exit(2)
+			}
+			talons[uint32(device)] = true
+		}
+	}
+	if len(talons) > 0 {
+		go fakeTalons(fd, talons)
+	}
+	if *scriptFlag != "" {
+		script, err := readScript(*scriptFlag)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(2)
+		}
+		go play(fd, script)
+	}
+	go report()
+
+	buffer := make([]byte, canFrameBytes)
+	for {
+		if n, err := syscall.Read(fd, buffer); err != nil || n != canFrameBytes {
+			continue
+		}
+		atomic.AddUint64(&received, 1)
+		id := binary.LittleEndian.Uint32(buffer) & effMask
+		if id&^deviceMask == talonControl && talons[id&deviceMask] {
+			atomic.AddUint64(&controls, 1)
+		}
+	}
+}
+
+func openBus(name string) (int, error) {
+	iface, err := net.InterfaceByName(name)
+	if err != nil {
+		return -1, err
+	}
+	fd, err := syscall.Socket(syscall.AF_CAN, syscall.SOCK_RAW, canRaw)
+	if err != nil {
+		return -1, fmt.Errorf("canbus: SocketCAN is not available: %v", err)
+	}
+	address := sockaddrCAN{family: syscall.AF_CAN, ifindex: int32(iface.Index)}
+	_, _, errno := syscall.Syscall(syscall.SYS_BIND, uintptr(fd), uintptr(unsafe.Pointer(&address)), unsafe.Sizeof(address))
+	if errno != 0 {
+		syscall.Close(fd)
+		return -1, fmt.Errorf("canbus: could not bind to %s: %v", name, errno)
+	}
+	return fd, nil
+}
+
+func send(fd int, f frame) {
+	var buffer [canFrameBytes]byte
+	binary.LittleEndian.PutUint32(buffer[:], f.id|effFlag)
+	buffer[4] = byte(copy(buffer[8:], f.data))
+	if _, err := syscall.Write(fd, buffer[:]); err == nil {
+		atomic.AddUint64(&sent, 1)
+	}
+}
+
+// Sends both general and feedback status frames so Phoenix sees each Talon as present
+func fakeTalons(fd int, talons map[uint32]bool) {
+	ticker := time.NewTicker(*statusFlag)
+	data := make([]byte, 8)
+	for range ticker.C {
+		for device := range talons {
+			send(fd, frame{talonStatus1 | device, data})
+			send(fd, frame{talonStatus2 | device, data})
+		}
+	}
+}
+
+func readScript(path string) ([]scriptLine, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer file.Close()
+	var script []scriptLine
+	scanner := bufio.NewScanner(file)
+	for number := 1; scanner.Scan(); number++ {
+		fields := strings.Fields(scanner.Text())
+		if len(fields) == 0 || strings.HasPrefix(fields[0], "#") {
+			continue
+		}
+		if len(fields) < 2 {
+			return nil, fmt.Errorf("%s:%d: expected time, ID and data", path, number)
+		}
+		ms, err := strconv.ParseFloat(fields[0], 64)
+		if err != nil {
+			return nil, fmt.Errorf("%s:%d: %v", path, number, err)
+		}
+		id, err := strconv.ParseUint(fields[1], 16, 29)
+		if err != nil {
+			return nil, fmt.Errorf("%s:%d: %v", path, number, err)
+		}
+		var data []byte
+		if len(fields) > 2 {
+			if data, err = hex.DecodeString(fields[2]); err != nil || len(data) > 8 {
+				return nil, fmt.Errorf("%s:%d: bad data %q", path, number, fields[2])
+			}
+		}
+		script = append(script, scriptLine{time.Duration(ms * float64(time.Millisecond)), frame{uint32(id), data}})
+	}
+	return script, scanner.Err()
+}
+
+func play(fd int, script []scriptLine) {
+	for {
+		start := time.Now()
+		for _, line := range script {
+			time.Sleep(time.Until(start.Add(line.at)))
+			send(fd, line.frame)
+		}
+		if !*loopFlag {
+			return
+		}
+	}
+}
+
+func report() {
+	var lastReceived, lastSent, lastControls uint64
+	for range time.Tick(time.Second) {
+		r, s, c := atomic.LoadUint64(&received), atomic.LoadUint64(&sent), atomic.LoadUint64(&controls)
+		fmt.Printf("received %6d/s  talon control %6d/s  sent %6d/s\n", r-lastReceived, c-lastControls, s-lastSent)
+		lastReceived, lastSent, lastControls = r, s, c
+	}
+}
+
+func flood(fd int, count int) {
+	data := make([]byte, 8)
+	start := time.Now()
+	for i := 0; i < count; i++ {
+		binary.LittleEndian.PutUint32(data, uint32(i))
+		send(fd, frame{talonStatus1, data})
+	}
+	elapsed := time.Since(start)
+	fmt.Printf("sent %d of %d frames in %v, %.0f frames/s\n", sent, count, elapsed, float64(sent)/elapsed.Seconds())
+}
@@ -0,0 +1,148 @@
+//go:build sim
+// +build sim
+
+// Works with the CAN logs recorded by the robot when frc.CANLogPath is set.
+// -dump prints a log in the script format of cmd/canbus, so a match can also be played onto a vcan bus.
+// -replay runs the robot code in the simulation with the log fed into the bus and records what the robot sent in
+// response, so two versions of the code can be compared on the same match.
+//
+//	go build -tags sim -o build/canlog go-frc/cmd/canlog
+//	build/canlog -dump match.canlog
+//	build/canlog -replay match.canlog -mode teleop -speed 10 -out sent.canlog
+package main
+
+import (
+	"flag"
+	"fmt"
+	"go-frc/frc"
+	"go-frc/frc/halsim"
+	"io"
+	"os"
+	"runtime"
+)
+
+var (
+	dumpFlag   = flag.String("dump", "", "CAN log to print")
+	replayFlag = flag.String("replay", "", "CAN log to replay against the robot code")
+	speedFlag  = flag.Float64("speed", 1, "replay speed relative to the recording")
+	modeFlag   = flag.String("mode", "teleop", "driver station mode during the replay: disabled, autonomous, teleop or test")
+	outFlag    = flag.String("out", "", "where to record the frames the robot sent during the replay")
+)
+
+func main() {
+	flag.Parse()
+	var err error
+	switch {
+	case *dumpFlag != "":
+		err = dump(*dumpFlag)
+	case *replayFlag != "":
+		err = replay(*replayFlag)
+	default:
+		flag.Usage()
+		os.Exit(2)
+	}
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+}
+
+func openLog(path string) (*frc.CANLogReader, func() error, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, nil, err
+	}
+	reader, err := frc.NewCANLogReader(file)
+	if err != nil {
+		file.Close()
+		return nil, nil, fmt.Errorf("%s: %v", path, err)
+	}
+	return reader, file.Close, nil
+}
+
+func dump(path string) error {
+	reader, closeLog, err := openLog(path)
+	if err != nil {
+		return err
+	}
+	defer closeLog()
+	var record frc.CANRecord
+	first, started := uint32(0), false
+	for {
+		if err := reader.Next(&record); err == io.EOF {
+			return nil
+		} else if err != nil {
+			return err
+		}
+		if !started {
+			first, started = record.TimeStamp, true
+		}
+		fmt.Printf("%d %x %x\n", record.TimeStamp-first, record.MessageID, record.Data[:record.Size])
+	}
+}
+
+func replay(path string) error {
+	reader, closeLog, err := openLog(path)
+	if err != nil {
+		return err
+	}
+	defer closeLog()
+	modes := map[string]halsim.ControlWord{
+		"disabled":   halsim.DisabledMode,
+		"autonomous": halsim.AutonomousMode,
+		"teleop":     halsim.TeleopMode,
+		"test":       halsim.TestMode,
+	}
+	mode, ok := modes[*modeFlag]
+	if !ok {
+		return fmt.Errorf("unknown mode %q", *modeFlag)
+	}
+
+	var sent *frc.CANLogWriter
+	if *outFlag != "" {
+		file, err := os.Create(*outFlag)
+		if err != nil {
+			return err
+		}
+		defer file.Close()
+		if sent, err = frc.NewCANLogWriter(file); err != nil {
+			return err
+		}
+	}
+
+	replay := frc.ReplayCANLog(reader, *speedFlag)
+	halsim.SetSteppedClock(true)
+	halsim.SetControlWord(mode)
+	go func() {
+		runtime.LockOSThread()
+		frc.Start()
+	}()
+
+	ticks, sentFrames := 0, 0
+	var frame halsim.CANFrame
+	for !replay.Done() {
+		halsim.StepTime(frc.Period)
+		ticks++
+		for halsim.ReadSentCANFrame(&frame) {
+			sentFrames++
+			if sent != nil {
+				record := frc.CANRecord{TimeStamp: frame.TimeStamp, MessageID: frame.MessageID, Data: frame.Data, Size: frame.Size}
+				if err := sent.Write(&record); err != nil {
+					return err
+				}
+			}
+		}
+	}
+	halsim.Shutdown()
+	if replay.Err() != io.EOF {
+		return fmt.Errorf("%s: %v", path, replay.Err())
+	}
+	if sent != nil {
+		if err := sent.Flush(); err != nil {
+			return err
+		}
+	}
+	fmt.Fprintf(os.Stderr, "replayed %d frames over %d ticks (%.1fs), the robot sent %d\n",
+		replay.Injected, ticks, float64(ticks)*frc.Period, sentFrames)
+	return nil
+}
@@ -0,0 +1,28 @@
+// Measures how late the HAL notifier, a Go ticker and a timerfd wake up a thread, idle and under CPU and GC load.
+// Runs on the roboRIO like the robot program, or on a computer with the sim tag.
+//
+//	go build -tags sim -o build/jitter go-frc/cmd/jitter
+//	build/jitter -ticks 5000 -period 5ms
+package main
+
+import (
+	"flag"
+	"go-frc/frc"
+	"runtime"
+	"time"
+)
+
+var (
+	ticksFlag  = flag.Int("ticks", 2000, "ticks per timing source and load")
+	periodFlag = flag.Duration("period", time.Duration(frc.Period*float64(time.Second)), "tick period")
+)
+
+func init() {
+	runtime.LockOSThread()
+}
+
+func main() {
+	flag.Parse()
+	frc.JitterCheck = frc.JitterConfig{Ticks: *ticksFlag, Period: periodFlag.Seconds()}
+	frc.Start()
+}
@@ -0,0 +1,121 @@
+// Decodes the data logs recorded by the robot when frc.DataLogPath is set. It only needs the log, not the HAL,
+// so it builds on any desktop. -signal reads just the named columns, skipping the rest of the file, and -events
+// prints the messages logged between ticks.
+//
+//	go build -o build/logdecode go-frc/cmd/logdecode
+//	build/logdecode -list match.datalog
+//	build/logdecode -signal "left velocity,right velocity" match.datalog > velocity.csv
+//	build/logdecode -json match.datalog
+package main
+
+import (
+	"bufio"
+	"encoding/json"
+	"flag"
+	"fmt"
+	"go-frc/frc/datalog"
+	"os"
+	"strconv"
+	"strings"
+)
+
+var (
+	listFlag   = flag.Bool("list", false, "print the signals in the log and exit")
+	eventsFlag = flag.Bool("events", false, "print the events in the log, such as device errors, and exit")
+	signalFlag = flag.String("signal", "", "comma separated signals to extract, all of them when empty")
+	jsonFlag   = flag.Bool("json", false, "print one JSON object of arrays, keyed by signal name, instead of CSV")
+)
+
+func main() {
+	flag.Parse()
+	if flag.NArg() != 1 {
+		fmt.Fprintln(os.Stderr, "usage: logdecode [-list | -events] [-signal names] [-json] file")
+		os.Exit(2)
+	}
+	file, err := os.Open(flag.Arg(0))
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+	defer file.Close()
+	reader, err := datalog.NewReader(file)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+
+	if *listFlag {
+		for _, signal := range reader.Signals {
+			kind := "float"
+			if signal.Type == datalog.Integer {
+				kind = "integer"
+			}
+			fmt.Printf("%s\t%s\t%s\t%g\n", signal.Name, signal.Units, kind, signal.Resolution)
+		}
+		return
+	}
+
+	if *eventsFlag {
+		events, err := reader.Events()
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(1)
+		}
+		for _, event := range events {
+			fmt.Printf("%.6f\t%s\n", event.Time, event.Text)
+		}
+		return
+	}
+
+	var indices []int
+	if *signalFlag == "" {
+		for i := range reader.Signals {
+			indices = append(indices, i)
+		}
+	} else {
+		for _, name := range strings.Split(*signalFlag, ",") {
+			index := reader.Find(strings.TrimSpace(name))
+			if index < 0 {
+				fmt.Fprintf(os.Stderr, "no signal named %q, -list shows what the log has\n", name)
+				os.Exit(1)
+			}
+			indices = append(indices, index)
+		}
+	}
+	times, columns, err := reader.Read(indices...)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+
+	out := bufio.NewWriter(os.Stdout)
+	defer out.Flush()
+	if *jsonFlag {
+		arrays := map[string][]float64{"time": times}
+		for i, index := range indices {
+			arrays[reader.Signals[index].Name] = columns[i]
+		}
+		json.NewEncoder(out).Encode(arrays)
+		return
+	}
+	out.WriteString("time")
+	for _, index := range indices {
+		signal := reader.Signals[index]
+		out.WriteByte(',')
+		out.WriteString(signal.Name)
+		if signal.Units != "" {
+			out.WriteString(" (" + signal.Units + ")")
+		}
+	}
+	out.WriteByte('\n')
+	var line []byte
+	for row, time := range times {
+		line = strconv.AppendFloat(line[:0], time, 'f', 6, 64)
+		for i := range indices {
+			line = append(line, ',')
+			line = strconv.AppendFloat(line, columns[i][row], 'g', -1, 64)
+		}
+		line = append(line, '\n')
+		out.Write(line)
+	}
+}
@@ -0,0 +1,229 @@
+//go:build sim && !socketcan
+// +build sim,!socketcan
+
+// Runs the autonomous routine against many randomized simulated robots and reports how often each set of gains succeeds.
+// Every trial is its own process since the robot code and the simulated HAL are global, which also keeps trials
+// from interfering with each other and spreads them across cores.
+//
+//	go build -tags sim -o build/montecarlo go-frc/cmd/montecarlo
+//	build/montecarlo -kp 0.8,1.2,2 -kd 0,0.1,0.3 -trials 200
+package main
+
+import (
+	"encoding/json"
+	"flag"
+	"fmt"
+	"go-frc/frc"
+	"go-frc/frc/halsim"
+	"math"
+	"math/rand"
+	"os"
+	"os/exec"
+	"runtime"
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+)
+
+const (
+	autonomousTicks = 15 / frc.Period
+)
+
+type trial struct {
+	KP, KD float64
+	Seed   int64
+}
+
+type result struct {
+	trial
+	FinalError float64 // Meters from the target at the end of autonomous
+	SettleTime float64 // Seconds until it stayed within tolerance, NaN if it never did
+	Success    bool
+}
+
+type summary struct {
+	KP, KD               float64
+	Trials, Successes    int
+	SuccessRate          float64
+	ErrorP50, ErrorP90   float64
+	SettleP50, SettleP90 float64
+}
+
+var (
+	kpFlag        = flag.String("kp", "0.8,1.2,2", "comma separated proportional gains")
+	kdFlag        = flag.String("kd", "0,0.1,0.3", "comma separated derivative gains")
+	trialsFlag    = flag.Int("trials", 100, "randomized trials per gain set")
+	parallelFlag  = flag.Int("parallel", runtime.NumCPU(), "trials run at once")
+	toleranceFlag = flag.Float64("tolerance", 0.05, "meters from the target that counts as success")
+	seedFlag      = flag.Int64("seed", 1, "base seed, trial seeds are derived from it")
+	jsonFlag      = flag.Bool("json", false, "print summaries as JSON")
+	trialFlag     = flag.String("trial", "", "internal, runs a single trial given as kp,kd,seed")
+)
+
+func main() {
+	flag.Parse()
+	if *trialFlag != "" {
+		runTrial(*trialFlag)
+		return
+	}
+	var trials []trial
+	for _, kp := range parseList(*kpFlag) {
+		for _, kd := range parseList(*kdFlag) {
+			for i := 0; i < *trialsFlag; i++ {
+				trials = append(trials, trial{kp, kd, *seedFlag + int64(i)})
+			}
+		}
+	}
+	results := runAll(trials)
+	summaries := summarize(results)
+	if *jsonFlag {
+		encoder := json.NewEncoder(os.Stdout)
+		encoder.SetIndent("", "  ")
+		encoder.Encode(summaries)
+		return
+	}
+	fmt.Printf("%8s %8s %8s %10s %10s %10s %10s\n", "kP", "kD", "success", "err p50", "err p90", "settle p50", "settle p90")
+	for _, s := range summaries {
+		fmt.Printf("%8.3g %8.3g %7.1f%% %9.3fm %9.3fm %9.2fs %9.2fs\n", s.KP, s.KD, s.SuccessRate*100,
+			s.ErrorP50, s.ErrorP90, s.SettleP50, s.SettleP90)
+	}
+}
+
+func parseList(list string) []float64 {
+	var values []float64
+	for _, field := range strings.Split(list, ",") {
+		value, err := strconv.ParseFloat(strings.TrimSpace(field), 64)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(2)
+		}
+		values = append(values, value)
+	}
+	return values
+}
+
+func runAll(trials []trial) []result {
+	// os.Args[0] is not a path to this binary when it was found through PATH or built by go run
+	executable, err := os.Executable()
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+	jobs := make(chan trial)
+	results := make([]result, 0, len(trials))
+	var mutex sync.Mutex
+	var group sync.WaitGroup
+	for w := 0; w < *parallelFlag; w++ {
+		group.Add(1)
+		go func() {
+			defer group.Done()
+			for job := range jobs {
+				output, err := exec.Command(executable, "-tolerance", fmt.Sprint(*toleranceFlag),
+					"-trial", fmt.Sprintf("%g,%g,%d", job.KP, job.KD, job.Seed)).Output()
+				var r result
+				if err == nil {
+					// The robot prints to stdout as well, the result is always the last line
+					lines := strings.Split(strings.TrimSpace(string(output)), "\n")
+					err = json.Unmarshal([]byte(lines[len(lines)-1]), &r)
+				}
+				if err != nil {
+					fmt.Fprintf(os.Stderr, "trial %+v failed: %v\n", job, err)
+					continue
+				}
+				mutex.Lock()
+				results = append(results, r)
+				mutex.Unlock()
+			}
+		}()
+	}
+	for _, job := range trials {
+		jobs <- job
+	}
+	close(jobs)
+	group.Wait()
+	return results
+}
+
+// Child process side, prints one result as JSON
+func runTrial(spec string) {
+	values := parseList(spec)
+	t := trial{values[0], values[1], int64(values[2])}
+	random := rand.New(rand.NewSource(t.Seed))
+	frc.AutoGains.KP, frc.AutoGains.KD = t.KP, t.KD
+	frc.SimConfig = frc.SimParameters{
+		BatteryVoltage:    11.8 + random.Float64()*1.2,
+		BatteryResistance: 0.015 + random.Float64()*0.015,
+		Friction:          random.Float64() * 40,
+		Mass:              55 + random.Float64()*10,
+		EncoderNoise:      random.Float64() * 20,
+		Seed:              t.Seed,
+	}
+
+	halsim.SetSteppedClock(true)
+	halsim.SetControlWord(halsim.AutonomousMode)
+	go func() {
+		runtime.LockOSThread()
+		frc.Start()
+	}()
+
+	r := result{trial: t, SettleTime: math.NaN()}
+	for tick := 0; tick < autonomousTicks; tick++ {
+		halsim.StepTime(frc.Period)
+		drive := frc.SimDrive()
+		travelled := (drive.LeftPosition[0] + drive.RightPosition[0]) / 2
+		r.FinalError = math.Abs(frc.AutoGains.Distance - travelled)
+		if r.FinalError > *toleranceFlag {
+			r.SettleTime = math.NaN()
+		} else if math.IsNaN(r.SettleTime) {
+			r.SettleTime = float64(tick+1) * frc.Period
+		}
+	}
+	halsim.Shutdown()
+	r.Success = r.FinalError <= *toleranceFlag
+	if math.IsNaN(r.SettleTime) {
+		r.SettleTime = -1 // JSON has no NaN
+	}
+	json.NewEncoder(os.Stdout).Encode(r)
+}
+
+func summarize(results []result) []summary {
+	groups := make(map[[2]float64][]result)
+	var keys [][2]float64
+	for _, r := range results {
+		key := [2]float64{r.KP, r.KD}
+		if _, ok := groups[key]; !ok {
+			keys = append(keys, key)
+		}
+		groups[key] = append(groups[key], r)
+	}
+	sort.Slice(keys, func(i, j int) bool {
+		return keys[i][0] < keys[j][0] || keys[i][0] == keys[j][0] && keys[i][1] < keys[j][1]
+	})
+	summaries := make([]summary, 0, len(keys))
+	for _, key := range keys {
+		group := groups[key]
+		s := summary{KP: key[0], KD: key[1], Trials: len(group)}
+		var errors, settles []float64
+		for _, r := range group {
+			errors = append(errors, r.FinalError)
+			if r.Success {
+				s.Successes++
+				settles = append(settles, r.SettleTime)
+			}
+		}
+		s.SuccessRate = float64(s.Successes) / float64(s.Trials)
+		s.ErrorP50, s.ErrorP90 = percentile(errors, 0.5), percentile(errors, 0.9)
+		s.SettleP50, s.SettleP90 = percentile(settles, 0.5), percentile(settles, 0.9)
+		summaries = append(summaries, s)
+	}
+	return summaries
+}
+
+func percentile(values []float64, p float64) float64 {
+	if len(values) == 0 {
+		return -1
+	}
+	sort.Float64s(values)
+	return values[int(p*float64(len(values)-1)+0.5)]
+}
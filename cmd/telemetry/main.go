@@ -0,0 +1,95 @@
+// Receives the live telemetry the robot sends when frc.TelemetryAddress is set and prints it as CSV, for piping
+// into a plotting tool or checking the publisher locally: run this on 127.0.0.1:5800 and point a simulated robot
+// at the same address. Lost datagrams are counted on stderr when it exits.
+//
+//	go build -o build/telemetry go-frc/cmd/telemetry
+//	build/telemetry -listen :5800 -signal "left velocity,right velocity"
+package main
+
+import (
+	"bufio"
+	"flag"
+	"fmt"
+	"go-frc/frc/telemetry"
+	"os"
+	"strconv"
+	"strings"
+)
+
+var (
+	listenFlag = flag.String("listen", ":5800", "address to receive telemetry on")
+	signalFlag = flag.String("signal", "", "comma separated signals to print, all of them when empty")
+	framesFlag = flag.Int("frames", 0, "exit after this many frames, zero runs until killed")
+)
+
+func main() {
+	flag.Parse()
+	client, err := telemetry.Listen(*listenFlag)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+	defer client.Close()
+	out := bufio.NewWriter(os.Stdout)
+	defer out.Flush()
+
+	var indices []int
+	frames := 0
+	for *framesFlag == 0 || frames < *framesFlag {
+		batch, err := client.Receive()
+		if err == telemetry.ErrBadDatagram {
+			continue
+		} else if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			break
+		}
+		// The header is printed once the schema is known, after that a new schema only matters if it changed
+		if indices == nil && client.Signals != nil {
+			if indices, err = selectSignals(client); err != nil {
+				fmt.Fprintln(os.Stderr, err)
+				os.Exit(1)
+			}
+			out.WriteString("time")
+			for _, index := range indices {
+				out.WriteString("," + client.Signals[index].Name)
+			}
+			out.WriteByte('\n')
+		}
+		var line []byte
+		for _, frame := range batch {
+			line = strconv.AppendFloat(line[:0], frame.Time, 'f', 6, 64)
+			for _, index := range indices {
+				line = append(line, ',')
+				line = strconv.AppendFloat(line, frame.Values[index], 'g', -1, 64)
+			}
+			out.Write(append(line, '\n'))
+			frames++
+		}
+		out.Flush()
+	}
+	fmt.Fprintf(os.Stderr, "%d frames, %d datagrams lost\n", frames, client.Lost)
+}
+
+func selectSignals(client *telemetry.Client) ([]int, error) {
+	var indices []int
+	if *signalFlag == "" {
+		for i := range client.Signals {
+			indices = append(indices, i)
+		}
+		return indices, nil
+	}
+	for _, name := range strings.Split(*signalFlag, ",") {
+		name = strings.TrimSpace(name)
+		found := false
+		for i, signal := range client.Signals {
+			if signal.Name == name {
+				indices = append(indices, i)
+				found = true
+			}
+		}
+		if !found {
+			return nil, fmt.Errorf("no signal named %q", name)
+		}
+	}
+	return indices, nil
+}
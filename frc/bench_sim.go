@@ -0,0 +1,66 @@
+//go:build sim && !socketcan
+// +build sim,!socketcan
+
+package frc
+
+// #include "hal.h"
+import "C"
+import (
+	"os"
+	"runtime"
+	"sync"
+)
+
+// The calls into C that bench_test.go needs, test files cannot use cgo
+
+var benchOnce sync.Once
+
+// Sets up the HAL and the robot the way Start would, without running the loop
+func benchInit() {
+	benchOnce.Do(func() {
+		if C.HAL_Initialize(500, 0) == 0 {
+			os.Exit(-1)
+		}
+		robotInit()
+	})
+}
+
+func observeTeleop() {
+	C.HAL_ObserveUserProgramTeleop()
+}
+
+// A HAL notifier with a thread waiting on it that signals woken every time it wakes
+type benchNotifier struct {
+	handle C.HAL_NotifierHandle
+	woken  chan struct{}
+}
+
+func newBenchNotifier() *benchNotifier {
+	status := C.int32_t(0)
+	notifier := &benchNotifier{handle: C.HAL_InitializeNotifier(&status), woken: make(chan struct{})}
+	handleErrorStatus(status)
+	go func() {
+		runtime.LockOSThread()
+		status := C.int32_t(0)
+		for C.HAL_WaitForNotifierAlarm(notifier.handle, &status) != 0 {
+			notifier.woken <- struct{}{}
+		}
+		close(notifier.woken)
+	}()
+	return notifier
+}
+
+// Sets an alarm that is already due and waits for the thread to wake up
+func (notifier *benchNotifier) wake() {
+	status := C.int32_t(0)
+	now := C.HAL_GetFPGATime(&status)
+	C.HAL_UpdateNotifierAlarm(notifier.handle, now, &status)
+	<-notifier.woken
+}
+
+func (notifier *benchNotifier) close() {
+	status := C.int32_t(0)
+	C.HAL_StopNotifier(notifier.handle, &status)
+	<-notifier.woken
+	C.HAL_CleanNotifier(notifier.handle, &status)
+}
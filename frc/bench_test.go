@@ -0,0 +1,198 @@
+//go:build sim && !socketcan
+// +build sim,!socketcan
+
+package frc
+
+import (
+	"fmt"
+	"go-frc/frc/drive"
+	"go-frc/frc/phoenix"
+	"go-frc/frc/rev"
+	"go-frc/frc/telemetry"
+	"math"
+	"testing"
+)
+
+// What the loop pays for each call into C and for a whole tick, against the simulated HAL and motor controllers.
+// Compare commits with benchstat, or keep a history with go test -json:
+//
+//	go test -tags sim -run X -bench . -benchmem ./frc/... | tee new.txt
+//	benchstat old.txt new.txt
+
+var (
+	benchPort  = 40 // Ports above the ones robotInit uses, every controller needs its own sim device
+	benchSpark *rev.Spark
+)
+
+func benchTalons(count int) []*phoenix.Talon {
+	benchInit()
+	talons := make([]*phoenix.Talon, count)
+	for i := range talons {
+		talons[i] = phoenix.NewTalon(benchPort)
+		benchPort++
+	}
+	return talons
+}
+
+func BenchmarkHAL_GetControlWord(b *testing.B) {
+	benchInit()
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		getHalStatusFlags()
+	}
+}
+
+func BenchmarkHAL_GetJoystickAxes(b *testing.B) {
+	benchInit()
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		getJoystickAxis(0, 1)
+	}
+}
+
+func BenchmarkHAL_GetFPGATime(b *testing.B) {
+	benchInit()
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		getFPGATime()
+	}
+}
+
+func BenchmarkCTRE_Set(b *testing.B) {
+	talon := benchTalons(1)[0]
+	for _, traced := range []bool{false, true} {
+		name := "untraced"
+		if traced {
+			name = "traced"
+			StartTrace()
+		}
+		b.Run(name, func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				talon.Set(float64(i&1) * 0.5)
+			}
+		})
+		if traced {
+			StopTrace()
+		}
+	}
+}
+
+// Benchmarks without sub-benchmarks run several times, so their controllers are only made the first time
+func BenchmarkREV_Set(b *testing.B) {
+	benchInit()
+	if benchSpark == nil {
+		benchSpark = rev.NewSpark(benchPort)
+		benchPort++
+	}
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		benchSpark.Set(float64(i&1) * 0.5)
+	}
+}
+
+// Time from updating an alarm to the waiting thread running again, the alarm is due immediately so this is only
+// the cost of the wake-up itself
+func BenchmarkNotifierWakeup(b *testing.B) {
+	benchInit()
+	notifier := newBenchNotifier()
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		notifier.wake()
+	}
+	b.StopTimer()
+	notifier.close()
+}
+
+// What the loop pays per tick for telemetry, from the tick's record to the publisher's ring, publishing to a client
+// on the loopback interface that reads everything sent while the benchmark runs
+func BenchmarkPublishTick(b *testing.B) {
+	benchInit()
+	if telemetryPublisher == nil {
+		client, err := telemetry.Listen("127.0.0.1:0")
+		if err != nil {
+			b.Fatal(err)
+		}
+		go func() {
+			for {
+				if _, err := client.Receive(); err != nil && err != telemetry.ErrBadDatagram {
+					return
+				}
+			}
+		}()
+		TelemetryAddress = client.Address()
+		if err := startTelemetry(); err != nil {
+			b.Fatal(err)
+		}
+	}
+	record := LogRecord{Mode: uint8(Teleop)}
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		record.Time = float64(i) * Period
+		record.Outputs[0] = float32(i&255) / 255
+		publishTick(&record)
+	}
+}
+
+// Everything a teleop tick does after the notifier wakes it, with the extra controllers following the drive output
+func BenchmarkTeleopTick(b *testing.B) {
+	benchInit()
+	for _, count := range []int{2, 8, 32} {
+		extra := benchTalons(count - 2)
+		b.Run(fmt.Sprintf("controllers=%d", count), func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				getHalStatusFlags()
+				observeTeleop()
+				teleopPeriodic()
+				output := getJoystickAxis(0, 1)
+				for _, talon := range extra {
+					talon.Set(output)
+				}
+				robotPeriodic()
+				for _, hook := range tickEndHooks {
+					hook()
+				}
+			}
+		})
+	}
+}
+
+// Four modules of Talons at the corners of a 60 cm square, drive ticks per meter as on the tank drive and a 4096
+// tick encoder on each azimuth
+func benchSwerveModules() []SwerveModule {
+	talons := benchTalons(8)
+	modules := make([]SwerveModule, 4)
+	for i := range modules {
+		modules[i] = SwerveModule{
+			X: 0.3 - 0.6*float64(i/2), Y: 0.3 - 0.6*float64(i%2),
+			Drive:   SwerveMotor{Talon: talons[2*i], Scale: DriveTicksPerMeter},
+			Azimuth: SwerveMotor{Talon: talons[2*i+1], Scale: 4096 / (2 * math.Pi)},
+		}
+		talons[2*i].ConfigPID(0.1, 0, 0, 0.05)
+		talons[2*i+1].ConfigPID(2, 0, 0, 0)
+	}
+	return modules
+}
+
+// A tick of a swerve drive spinning while it drives, with the same kinematics either way. Batched it makes two
+// calls into C, unbatched a read and a set for each motor
+func BenchmarkSwerveDrive(b *testing.B) {
+	batched := NewSwerveDrive(4, benchSwerveModules()...)
+	unbatched := NewSwerveDrive(4, benchSwerveModules()...)
+	unbatched.unbatched = true
+	for _, swerve := range []*SwerveDrive{batched, unbatched} {
+		name := "batched"
+		if swerve.unbatched {
+			name = "unbatched"
+		}
+		b.Run(name, func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				swerve.Drive(drive.ChassisSpeeds{Vx: 1, Vy: float64(i&1) * 0.5, Omega: 1})
+			}
+		})
+	}
+}
@@ -0,0 +1,209 @@
+package frc
+
+// #include "hal.h"
+import "C"
+import (
+	"bufio"
+	"encoding/binary"
+	"errors"
+	"io"
+	"sync/atomic"
+	"time"
+	"unsafe"
+)
+
+// A CAN log starts with this header, then has one record per frame: uvarint milliseconds since the previous frame
+// (since zero for the first), uvarint arbitration ID, data size byte and the data bytes.
+// Timestamps are the FPGA milliseconds the HAL stamped the frame with when it was received
+const canLogHeader = "FRCCAN\x00\x01"
+
+const (
+	canSessionSize = 256 // Frames the HAL buffers between two reads
+	canReadBatch   = 64
+	canFlushPeriod = time.Second // Most that is lost if the robot loses power
+
+	halCANSessionOverrun = 44050
+)
+
+type CANRecord struct {
+	TimeStamp uint32 // FPGA milliseconds, wraps after about 50 days
+	MessageID uint32
+	Data      [8]byte
+	Size      uint8
+}
+
+// Records every frame received on the bus through a HAL stream session with an empty mask.
+// The same frames reach the Phoenix stream sessions, so this also covers what the Talons report
+type CANRecorder struct {
+	session  C.uint32_t
+	writer   *bufio.Writer
+	overruns uint32
+	stop     chan struct{}
+	done     chan error
+}
+
+func NewCANRecorder(w io.Writer, period time.Duration) *CANRecorder {
+	status := C.int32_t(0)
+	var session C.uint32_t
+	C.HAL_CAN_OpenStreamSession(&session, 0, 0, canSessionSize, &status)
+	handleErrorStatus(status)
+	recorder := &CANRecorder{
+		session: session,
+		writer:  bufio.NewWriterSize(w, 64*1024),
+		stop:    make(chan struct{}),
+		done:    make(chan error, 1),
+	}
+	go recorder.run(period)
+	return recorder
+}
+
+func (recorder *CANRecorder) run(period time.Duration) {
+	ticker := time.NewTicker(period)
+	defer ticker.Stop()
+	encoder := canLogEncoder{writer: recorder.writer}
+	_, err := recorder.writer.WriteString(canLogHeader)
+	var messages [canReadBatch]C.struct_HAL_CANStreamMessage
+	lastFlush := time.Now()
+	trace := traceName("CAN log read")
+	for err == nil {
+		select {
+		case <-recorder.stop:
+			err = recorder.drain(&encoder, &messages)
+			if err == nil {
+				err = recorder.writer.Flush()
+			}
+			recorder.done <- err
+			return
+		case <-ticker.C:
+		}
+		traceBegin(trace)
+		err = recorder.drain(&encoder, &messages)
+		if err == nil && time.Since(lastFlush) >= canFlushPeriod {
+			err = recorder.writer.Flush()
+			lastFlush = time.Now()
+		}
+		traceEnd(trace)
+	}
+	<-recorder.stop
+	recorder.done <- err
+}
+
+func (recorder *CANRecorder) drain(encoder *canLogEncoder, messages *[canReadBatch]C.struct_HAL_CANStreamMessage) error {
+	for {
+		status := C.int32_t(0)
+		read := C.uint32_t(0)
+		C.HAL_CAN_ReadStreamSession(recorder.session, &messages[0], canReadBatch, &read, &status)
+		if status == halCANSessionOverrun {
+			atomic.AddUint32(&recorder.overruns, 1)
+		}
+		for i := 0; i < int(read); i++ {
+			message := &messages[i]
+			record := CANRecord{
+				TimeStamp: uint32(message.timeStamp),
+				MessageID: uint32(message.messageID),
+				Data:      *(*[8]byte)(unsafe.Pointer(&message.data[0])),
+				Size:      uint8(message.dataSize),
+			}
+			if err := encoder.encode(&record); err != nil {
+				return err
+			}
+		}
+		if read < canReadBatch {
+			return nil
+		}
+	}
+}
+
+// Times the HAL buffer filled up between reads and frames were lost
+func (recorder *CANRecorder) Overruns() int {
+	return int(atomic.LoadUint32(&recorder.overruns))
+}
+
+// Stops recording and flushes what is left, the writer is not closed
+func (recorder *CANRecorder) Close() error {
+	close(recorder.stop)
+	err := <-recorder.done
+	C.HAL_CAN_CloseStreamSession(recorder.session)
+	return err
+}
+
+type canLogEncoder struct {
+	writer  *bufio.Writer
+	last    uint32
+	scratch [2*binary.MaxVarintLen32 + 9]byte
+}
+
+func (encoder *canLogEncoder) encode(record *CANRecord) error {
+	size := record.Size
+	if size > 8 {
+		size = 8
+	}
+	n := binary.PutUvarint(encoder.scratch[:], uint64(record.TimeStamp-encoder.last))
+	n += binary.PutUvarint(encoder.scratch[n:], uint64(record.MessageID))
+	encoder.scratch[n] = size
+	n += 1 + copy(encoder.scratch[n+1:], record.Data[:size])
+	encoder.last = record.TimeStamp
+	_, err := encoder.writer.Write(encoder.scratch[:n])
+	return err
+}
+
+// Writes records in the CAN log format, for building logs from something other than the HAL
+type CANLogWriter struct {
+	encoder canLogEncoder
+}
+
+func NewCANLogWriter(w io.Writer) (*CANLogWriter, error) {
+	writer := bufio.NewWriter(w)
+	if _, err := writer.WriteString(canLogHeader); err != nil {
+		return nil, err
+	}
+	return &CANLogWriter{canLogEncoder{writer: writer}}, nil
+}
+
+func (writer *CANLogWriter) Write(record *CANRecord) error {
+	return writer.encoder.encode(record)
+}
+
+func (writer *CANLogWriter) Flush() error {
+	return writer.encoder.writer.Flush()
+}
+
+var ErrNotCANLog = errors.New("frc: not a CAN log")
+
+type CANLogReader struct {
+	reader *bufio.Reader
+	last   uint32
+}
+
+func NewCANLogReader(r io.Reader) (*CANLogReader, error) {
+	reader := bufio.NewReader(r)
+	header := make([]byte, len(canLogHeader))
+	if _, err := io.ReadFull(reader, header); err != nil || string(header) != canLogHeader {
+		return nil, ErrNotCANLog
+	}
+	return &CANLogReader{reader: reader}, nil
+}
+
+// Fills in the next record, io.EOF once the log is finished
+func (reader *CANLogReader) Next(record *CANRecord) error {
+	delta, err := binary.ReadUvarint(reader.reader)
+	if err != nil {
+		return err
+	}
+	id, err := binary.ReadUvarint(reader.reader)
+	if err != nil {
+		return io.ErrUnexpectedEOF
+	}
+	size, err := reader.reader.ReadByte()
+	if err != nil || size > 8 {
+		return io.ErrUnexpectedEOF
+	}
+	record.MessageID, record.Size = uint32(id), size
+	record.Data = [8]byte{}
+	if _, err := io.ReadFull(reader.reader, record.Data[:size]); err != nil {
+		return io.ErrUnexpectedEOF
+	}
+	reader.last += uint32(delta)
+	record.TimeStamp = reader.last
+	return nil
+}
@@ -0,0 +1,58 @@
+//go:build sim
+// +build sim
+
+package frc
+
+import "go-frc/frc/halsim"
+
+// Feeds a recorded CAN log into the simulated bus. At the end of every tick the frames that are due by the HAL clock
+// are injected, so a replay follows the stepped clock as well as real time. The simulated motor controllers read
+// their sensors from the status frames among them, so the robot code reacts to the match as it was recorded
+type CANReplay struct {
+	Speed    float64 // 1 replays at the recorded timing, 4 four times as fast
+	Injected int
+
+	reader   *CANLogReader
+	next     CANRecord
+	logStart uint32
+	start    float64
+	started  bool
+	err      error
+}
+
+// Starts replaying once the loop runs, call before Start
+func ReplayCANLog(reader *CANLogReader, speed float64) *CANReplay {
+	replay := &CANReplay{Speed: speed, reader: reader}
+	onTickEnd(replay.advance)
+	return replay
+}
+
+func (replay *CANReplay) advance() {
+	if replay.err != nil {
+		return
+	}
+	now := getFPGATime()
+	if !replay.started {
+		if replay.err = replay.reader.Next(&replay.next); replay.err != nil {
+			return
+		}
+		replay.logStart, replay.start, replay.started = replay.next.TimeStamp, now, true
+	}
+	for float64(replay.next.TimeStamp-replay.logStart)/1000/replay.Speed <= now-replay.start {
+		halsim.InjectCANFrame(replay.next.MessageID, replay.next.Data[:replay.next.Size])
+		replay.Injected++
+		if replay.err = replay.reader.Next(&replay.next); replay.err != nil {
+			return
+		}
+	}
+}
+
+// True once every frame of the log has been injected or it could not be read any further
+func (replay *CANReplay) Done() bool {
+	return replay.err != nil
+}
+
+// Why the replay stopped, io.EOF when the whole log was replayed
+func (replay *CANReplay) Err() error {
+	return replay.err
+}
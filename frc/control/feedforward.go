@@ -0,0 +1,27 @@
+package control
+
+// Output needed to move a mechanism at a velocity and acceleration: KS overcomes static friction, KV holds the
+// velocity against back EMF and KA accelerates the load
+type Feedforward struct {
+	KS, KV, KA float64
+}
+
+func (feedforward *Feedforward) Calculate(velocity, acceleration float64) float64 {
+	output := feedforward.KV*velocity + feedforward.KA*acceleration
+	if velocity > 0 {
+		output += feedforward.KS
+	} else if velocity < 0 {
+		output -= feedforward.KS
+	}
+	return output
+}
+
+func CalculateFeedforwards(feedforwards []Feedforward, velocities, accelerations, outputs []float64) {
+	if len(feedforwards) == 0 {
+		return
+	}
+	_, _, _ = velocities[len(feedforwards)-1], accelerations[len(feedforwards)-1], outputs[len(feedforwards)-1]
+	for i := range feedforwards {
+		outputs[i] = feedforwards[i].Calculate(velocities[i], accelerations[i])
+	}
+}
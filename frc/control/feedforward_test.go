@@ -0,0 +1,24 @@
+package control
+
+import (
+	"fmt"
+	"testing"
+)
+
+func BenchmarkCalculateFeedforwards(b *testing.B) {
+	for _, channels := range benchChannels {
+		b.Run(fmt.Sprintf("channels=%d", channels), func(b *testing.B) {
+			feedforwards := make([]Feedforward, channels)
+			velocities, accelerations, outputs := make([]float64, channels), make([]float64, channels), make([]float64, channels)
+			for i := range feedforwards {
+				feedforwards[i] = Feedforward{KS: 0.05, KV: 0.2, KA: 0.01}
+				velocities[i] = float64(i) - float64(channels)/2
+			}
+			b.ReportAllocs()
+			for n := 0; n < b.N; n += channels {
+				accelerations[n%channels] += 0.01
+				CalculateFeedforwards(feedforwards, velocities, accelerations, outputs)
+			}
+		})
+	}
+}
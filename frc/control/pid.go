@@ -0,0 +1,59 @@
+// Feedback and feed-forward control for mechanisms. Controllers are plain structs the caller allocates once, so
+// updating them never allocates, and every controller has a function that updates a whole slice of them in one loop,
+// one channel per mechanism. Updates take the seconds since the last one, so the same controllers run in the loop
+// or in a faster frc.Task
+package control
+
+// Feedback on the difference between a setpoint and a measurement. The zero value is a controller with no gains
+type PID struct {
+	KP, KI, KD float64
+	MaxOutput  float64 // The output is clamped to plus or minus this, zero for no limit
+
+	integral, lastDeviation float64
+	primed                  bool
+}
+
+// The output for one step dt seconds after the last one. The integral only grows while the output is not held at
+// its limit in the same direction, so it does not wind up while the mechanism is saturated
+func (pid *PID) Update(setpoint, measurement, dt float64) float64 {
+	deviation := setpoint - measurement
+	derivative := 0.0
+	if pid.primed && dt > 0 {
+		derivative = (deviation - pid.lastDeviation) / dt
+	}
+	pid.lastDeviation, pid.primed = deviation, true
+	integral := pid.integral + deviation*dt
+	output := pid.KP*deviation + pid.KI*integral + pid.KD*derivative
+	if pid.MaxOutput > 0 {
+		if output > pid.MaxOutput {
+			output = pid.MaxOutput
+			if deviation > 0 {
+				integral = pid.integral
+			}
+		} else if output < -pid.MaxOutput {
+			output = -pid.MaxOutput
+			if deviation < 0 {
+				integral = pid.integral
+			}
+		}
+	}
+	pid.integral = integral
+	return output
+}
+
+// Forgets the integral and the last deviation, for when the mechanism was disabled or the setpoint jumped
+func (pid *PID) Reset() {
+	pid.integral, pid.lastDeviation, pid.primed = 0, 0, false
+}
+
+// Updates every controller with the setpoint and measurement at the same index, writing into outputs
+func UpdatePIDs(pids []PID, setpoints, measurements, outputs []float64, dt float64) {
+	if len(pids) == 0 {
+		return
+	}
+	// Lets the compiler drop the bounds checks inside the loop
+	_, _, _ = setpoints[len(pids)-1], measurements[len(pids)-1], outputs[len(pids)-1]
+	for i := range pids {
+		outputs[i] = pids[i].Update(setpoints[i], measurements[i], dt)
+	}
+}
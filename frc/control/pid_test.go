@@ -0,0 +1,79 @@
+package control
+
+import (
+	"fmt"
+	"math"
+	"testing"
+)
+
+// The loop's period
+const dt = 0.02
+
+var benchChannels = []int{2, 8, 32}
+
+func TestPIDAntiWindup(t *testing.T) {
+	tests := []struct {
+		name                     string
+		pid                      PID
+		integral                 float64 // Wound up before the steps
+		setpoint, measurement    float64
+		wantIntegral, wantOutput float64
+	}{
+		{"held high", PID{KP: 1, KI: 1, MaxOutput: 1}, 0, 10, 0, 0, 1},
+		{"held low", PID{KP: 1, KI: 1, MaxOutput: 1}, 0, -10, 0, 0, -1},
+		{"unwinds while held high", PID{KP: 0.1, KI: 1, MaxOutput: 1}, 50, 0, 1, 48, 1},
+		{"unwinds while held low", PID{KP: 0.1, KI: 1, MaxOutput: 1}, -50, 0, -1, -48, -1},
+		{"within the limit", PID{KP: 0.01, KI: 0.01, MaxOutput: 1}, 0, 1, 0, 2, 0.03},
+		{"no limit", PID{KP: 1, KI: 1}, 0, 10, 0, 20, 30},
+	}
+	for _, test := range tests {
+		t.Run(test.name, func(t *testing.T) {
+			pid := test.pid
+			pid.integral = test.integral
+			output := 0.0
+			for i := 0; i < 100; i++ {
+				output = pid.Update(test.setpoint, test.measurement, dt)
+				if pid.MaxOutput > 0 && math.Abs(output) > pid.MaxOutput {
+					t.Fatalf("step %d: output %g beyond the limit", i, output)
+				}
+			}
+			if math.Abs(pid.integral-test.wantIntegral) > 1e-9 {
+				t.Errorf("integral %g, want %g", pid.integral, test.wantIntegral)
+			}
+			if math.Abs(output-test.wantOutput) > 1e-9 {
+				t.Errorf("output %g, want %g", output, test.wantOutput)
+			}
+		})
+	}
+}
+
+// A mechanism held at its limit recovers as soon as it passes the setpoint, instead of overshooting while the
+// integral unwinds
+func TestPIDRecoversFromSaturation(t *testing.T) {
+	pid := PID{KP: 0.5, KI: 2, MaxOutput: 1}
+	for i := 0; i < 500; i++ {
+		pid.Update(100, 0, dt)
+	}
+	if output := pid.Update(100, 100.5, dt); output >= 0 {
+		t.Errorf("output %g past the setpoint, want it negative", output)
+	}
+}
+
+// Every channel is updated in one pass and counted as an operation, so ns/op is the cost of one channel
+func BenchmarkUpdatePIDs(b *testing.B) {
+	for _, channels := range benchChannels {
+		b.Run(fmt.Sprintf("channels=%d", channels), func(b *testing.B) {
+			pids := make([]PID, channels)
+			setpoints, measurements, outputs := make([]float64, channels), make([]float64, channels), make([]float64, channels)
+			for i := range pids {
+				pids[i] = PID{KP: 0.5, KI: 0.1, KD: 0.01, MaxOutput: 1}
+				setpoints[i] = float64(i)
+			}
+			b.ReportAllocs()
+			for n := 0; n < b.N; n += channels {
+				measurements[n%channels] += 0.01
+				UpdatePIDs(pids, setpoints, measurements, outputs, dt)
+			}
+		})
+	}
+}
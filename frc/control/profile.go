@@ -0,0 +1,108 @@
+package control
+
+import "math"
+
+type State struct {
+	Position, Velocity float64
+}
+
+// Limits of a trapezoid motion profile, which accelerates at MaxAcceleration up to MaxVelocity, cruises and then
+// slows down at MaxAcceleration to reach the goal
+type Constraints struct {
+	MaxVelocity, MaxAcceleration float64
+}
+
+// Where a trapezoid profile from current to goal is dt seconds later. The profile is worked out again from current
+// every step, so a goal that moves is followed without planning ahead
+func (constraints *Constraints) Next(current, goal State, dt float64) State {
+	// The profile is worked out moving forward, a profile moving back is mirrored
+	direction := 1.0
+	if current.Position > goal.Position {
+		direction = -1
+		current = State{-current.Position, -current.Velocity}
+		goal = State{-goal.Position, -goal.Velocity}
+	}
+	maxVelocity, acceleration := constraints.MaxVelocity, constraints.MaxAcceleration
+	current.Velocity = math.Min(current.Velocity, maxVelocity)
+
+	// Extend the profile back to zero velocity at both ends, so it is a whole trapezoid cut short by the ends
+	cutoffBegin := current.Velocity / acceleration
+	cutoffEnd := goal.Velocity / acceleration
+	fullDistance := cutoffBegin*cutoffBegin*acceleration/2 + goal.Position - current.Position +
+		cutoffEnd*cutoffEnd*acceleration/2
+	accelerationTime := maxVelocity / acceleration
+	cruiseDistance := fullDistance - accelerationTime*accelerationTime*acceleration
+	if cruiseDistance < 0 {
+		// Too short to reach full speed, a triangle instead
+		accelerationTime = math.Sqrt(fullDistance / acceleration)
+		cruiseDistance = 0
+	}
+	endAcceleration := accelerationTime - cutoffBegin
+	endCruise := endAcceleration + cruiseDistance/maxVelocity
+	endDeceleration := endCruise + accelerationTime - cutoffEnd
+
+	next := current
+	switch {
+	case dt < endAcceleration:
+		next.Velocity += dt * acceleration
+		next.Position += (current.Velocity + dt*acceleration/2) * dt
+	case dt < endCruise:
+		next.Velocity = maxVelocity
+		next.Position += (current.Velocity+endAcceleration*acceleration/2)*endAcceleration +
+			maxVelocity*(dt-endAcceleration)
+	case dt <= endDeceleration:
+		left := endDeceleration - dt
+		next.Velocity = goal.Velocity + left*acceleration
+		next.Position = goal.Position - (goal.Velocity+left*acceleration/2)*left
+	default:
+		next = goal
+	}
+	return State{next.Position * direction, next.Velocity * direction}
+}
+
+// PID on a setpoint that follows a trapezoid profile to Goal, plus feed-forward on the setpoint's motion
+type ProfiledPID struct {
+	PID
+	Constraints Constraints
+	Feedforward Feedforward
+	Goal        State
+
+	setpoint State
+}
+
+// Moves the setpoint one step towards Goal and returns the output for it
+func (profiled *ProfiledPID) Update(measurement, dt float64) float64 {
+	next := profiled.Constraints.Next(profiled.setpoint, profiled.Goal, dt)
+	acceleration := 0.0
+	if dt > 0 {
+		acceleration = (next.Velocity - profiled.setpoint.Velocity) / dt
+	}
+	profiled.setpoint = next
+	output := profiled.PID.Update(next.Position, measurement, dt) +
+		profiled.Feedforward.Calculate(next.Velocity, acceleration)
+	if profiled.MaxOutput > 0 {
+		output = math.Max(-profiled.MaxOutput, math.Min(profiled.MaxOutput, output))
+	}
+	return output
+}
+
+// Where the profile is now, for logging or for feeding a follower
+func (profiled *ProfiledPID) Setpoint() State {
+	return profiled.setpoint
+}
+
+// Starts the profile from where the mechanism is, call it when enabling
+func (profiled *ProfiledPID) Reset(measured State) {
+	profiled.setpoint = measured
+	profiled.PID.Reset()
+}
+
+func UpdateProfiledPIDs(profiled []ProfiledPID, measurements, outputs []float64, dt float64) {
+	if len(profiled) == 0 {
+		return
+	}
+	_, _ = measurements[len(profiled)-1], outputs[len(profiled)-1]
+	for i := range profiled {
+		outputs[i] = profiled[i].Update(measurements[i], dt)
+	}
+}
@@ -0,0 +1,73 @@
+package control
+
+import (
+	"fmt"
+	"math"
+	"testing"
+)
+
+func TestConstraintsNextReachesGoal(t *testing.T) {
+	constraints := Constraints{MaxVelocity: 2, MaxAcceleration: 4}
+	tests := []struct {
+		name          string
+		current, goal State
+		goalVelocity  float64 // Of a goal that moves every step
+		within        float64 // Seconds the goal should be reached in
+	}{
+		{"trapezoid", State{0, 0}, State{5, 0}, 0, 3},
+		{"mirrored trapezoid", State{0, 0}, State{-5, 0}, 0, 3},
+		{"triangle", State{0, 0}, State{0.5, 0}, 0, math.Sqrt(0.5)},
+		{"mirrored triangle", State{1, 0}, State{0.5, 0}, 0, math.Sqrt(0.5)},
+		{"already cruising", State{0, 2}, State{3, 0}, 0, 1.75},
+		{"moving away from the goal", State{0, -1}, State{1, 0}, 0, 1.3125},
+		{"at the goal", State{1, 0}, State{1, 0}, 0, 0},
+		{"moving goal", State{0, 0}, State{1, 0.5}, 0.5, 2},
+		{"mirrored moving goal", State{0, 0}, State{-1, -0.5}, -0.5, 2},
+	}
+	for _, test := range tests {
+		t.Run(test.name, func(t *testing.T) {
+			state, goal := test.current, test.goal
+			for step := 1; step <= 500; step++ {
+				next := constraints.Next(state, goal, dt)
+				if math.Abs(next.Velocity) > constraints.MaxVelocity+1e-9 {
+					t.Fatalf("step %d: velocity %g beyond the limit", step, next.Velocity)
+				}
+				if math.Abs(next.Velocity-state.Velocity) > constraints.MaxAcceleration*dt+1e-9 {
+					t.Fatalf("step %d: velocity %g to %g beyond the acceleration", step, state.Velocity, next.Velocity)
+				}
+				state = next
+				if math.Abs(state.Position-goal.Position) < 1e-9 && math.Abs(state.Velocity-goal.Velocity) < 1e-9 {
+					if elapsed := float64(step) * dt; elapsed > test.within+2*dt {
+						t.Errorf("reached the goal after %gs, want %gs", elapsed, test.within)
+					}
+					return
+				}
+				goal.Position += test.goalVelocity * dt
+			}
+			t.Fatalf("ended at %+v, goal %+v", state, goal)
+		})
+	}
+}
+
+func BenchmarkUpdateProfiledPIDs(b *testing.B) {
+	for _, channels := range benchChannels {
+		b.Run(fmt.Sprintf("channels=%d", channels), func(b *testing.B) {
+			profiled := make([]ProfiledPID, channels)
+			measurements, outputs := make([]float64, channels), make([]float64, channels)
+			for i := range profiled {
+				profiled[i] = ProfiledPID{
+					PID:         PID{KP: 0.5, KD: 0.01, MaxOutput: 1},
+					Constraints: Constraints{MaxVelocity: 2, MaxAcceleration: 4},
+					Feedforward: Feedforward{KS: 0.05, KV: 0.2, KA: 0.01},
+				}
+			}
+			b.ReportAllocs()
+			// Each channel chases a goal that keeps moving, so the profile is always mid-trapezoid
+			for n := 0; n < b.N; n += channels {
+				goal := &profiled[n%channels].Goal
+				goal.Position = -goal.Position + 1
+				UpdateProfiledPIDs(profiled, measurements, outputs, dt)
+			}
+		})
+	}
+}
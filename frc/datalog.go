@@ -0,0 +1,201 @@
+package frc
+
+import (
+	"fmt"
+	"go-frc/frc/datalog"
+	"io"
+	"runtime"
+	"sync"
+	"sync/atomic"
+	"syscall"
+	"time"
+)
+
+const (
+	LogAxes    = 6
+	LogOutputs = 8
+	LogSensors = 12
+
+	dataLogDrainPeriod = 250 * time.Millisecond
+	dataLogFlushPeriod = time.Second // A block is written at least this often, even if it is not full
+)
+
+// Names of the output and sensor slots of LogRecord, the robot code fills these in before Start.
+// Slots without a name are not written to the log
+var (
+	OutputSignals [LogOutputs]datalog.Signal
+	SensorSignals [LogSensors]datalog.Signal
+)
+
+// What the robot did in one tick
+type LogRecord struct {
+	Time    float64 // FPGA seconds when the tick started
+	Flags   uint8   // Control word flags, FEnabled and so on
+	Mode    uint8
+	Axes    [LogAxes]float32
+	Outputs [LogOutputs]float32
+	Sensors [LogSensors]float32
+}
+
+// Records ticks into a preallocated ring which a background goroutine writes out in large blocks.
+// There is a single producer, the loop thread, which never blocks or allocates. When the writer falls so far
+// behind that the ring is full, new records are dropped and counted instead
+type DataLog struct {
+	records  []LogRecord
+	head     uint64 // Next slot the loop writes, only changed by the loop
+	tail     uint64 // Next slot the writer reads, only changed by the writer
+	dropped  uint64
+	writer   *datalog.Writer
+	columns  []func(record *LogRecord) float64
+	stop     chan struct{}
+	done     chan error
+	reserved bool
+
+	eventLock sync.Mutex
+	events    []datalog.Event
+}
+
+// Writes the schema right away, so only call it during init
+func NewDataLog(w io.Writer, capacity int) (*DataLog, error) {
+	dataLog := &DataLog{
+		records: make([]LogRecord, capacity),
+		stop:    make(chan struct{}),
+		done:    make(chan error, 1),
+	}
+	signals, columns := recordSignals()
+	dataLog.columns = columns
+	writer, err := datalog.NewWriter(w, signals)
+	if err != nil {
+		return nil, err
+	}
+	dataLog.writer = writer
+	go dataLog.run()
+	return dataLog, nil
+}
+
+// The signals of a LogRecord that are written out, and how to get each one from a record
+func recordSignals() ([]datalog.Signal, []func(record *LogRecord) float64) {
+	signals := []datalog.Signal{{Name: "flags", Type: datalog.Integer}, {Name: "mode", Type: datalog.Integer}}
+	columns := []func(*LogRecord) float64{
+		func(record *LogRecord) float64 { return float64(record.Flags) },
+		func(record *LogRecord) float64 { return float64(record.Mode) },
+	}
+	for i := 0; i < LogAxes; i++ {
+		i := i
+		signals = append(signals, datalog.Signal{Name: fmt.Sprintf("axis %d", i), Resolution: 1e-3})
+		columns = append(columns, func(record *LogRecord) float64 { return float64(record.Axes[i]) })
+	}
+	for i, signal := range OutputSignals {
+		i := i
+		if signal.Name != "" {
+			signals = append(signals, signal)
+			columns = append(columns, func(record *LogRecord) float64 { return float64(record.Outputs[i]) })
+		}
+	}
+	for i, signal := range SensorSignals {
+		i := i
+		if signal.Name != "" {
+			signals = append(signals, signal)
+			columns = append(columns, func(record *LogRecord) float64 { return float64(record.Sensors[i]) })
+		}
+	}
+	return signals, columns
+}
+
+// Slot for the next record, nil if the ring is full. Fill it in and call Commit, loop thread only
+func (dataLog *DataLog) Reserve() *LogRecord {
+	head := dataLog.head
+	if head-atomic.LoadUint64(&dataLog.tail) == uint64(len(dataLog.records)) {
+		atomic.AddUint64(&dataLog.dropped, 1)
+		return nil
+	}
+	dataLog.reserved = true
+	record := &dataLog.records[head%uint64(len(dataLog.records))]
+	*record = LogRecord{}
+	return record
+}
+
+// Hands the reserved record over to the writer
+func (dataLog *DataLog) Commit() {
+	if dataLog.reserved {
+		dataLog.reserved = false
+		atomic.StoreUint64(&dataLog.head, dataLog.head+1)
+	}
+}
+
+// Queues a message for the next block. It takes a lock, so it is for other goroutines and not the loop
+func (dataLog *DataLog) Event(time float64, text string) {
+	dataLog.eventLock.Lock()
+	dataLog.events = append(dataLog.events, datalog.Event{Time: time, Text: text})
+	dataLog.eventLock.Unlock()
+}
+
+// Records lost because the ring was full
+func (dataLog *DataLog) Dropped() uint64 {
+	return atomic.LoadUint64(&dataLog.dropped)
+}
+
+func (dataLog *DataLog) run() {
+	// Writing to flash can take a while, that thread should lose to the loop and the vendor threads
+	runtime.LockOSThread()
+	syscall.Setpriority(syscall.PRIO_PROCESS, syscall.Gettid(), 19)
+	nameThread("data log")
+	trace := traceName("data log write")
+
+	ticker := time.NewTicker(dataLogDrainPeriod)
+	defer ticker.Stop()
+	values := make([]float64, len(dataLog.columns))
+	lastFlush := time.Now()
+	var err error
+	for {
+		stopping := false
+		select {
+		case <-dataLog.stop:
+			stopping = true
+		case <-ticker.C:
+		}
+		traceBegin(trace)
+		dataLog.eventLock.Lock()
+		for _, event := range dataLog.events {
+			dataLog.writer.Event(event.Time, event.Text)
+		}
+		dataLog.events = dataLog.events[:0]
+		dataLog.eventLock.Unlock()
+		if err == nil {
+			err = dataLog.drain(values)
+		}
+		if err == nil && (stopping || time.Since(lastFlush) >= dataLogFlushPeriod) {
+			err = dataLog.writer.Flush()
+			lastFlush = time.Now()
+		}
+		traceEnd(trace)
+		if stopping {
+			dataLog.done <- err
+			return
+		}
+	}
+}
+
+// Moves every committed record into the column writer, which writes each block as it fills up
+func (dataLog *DataLog) drain(values []float64) error {
+	head := atomic.LoadUint64(&dataLog.head)
+	for tail := dataLog.tail; tail != head; tail++ {
+		record := &dataLog.records[tail%uint64(len(dataLog.records))]
+		for i, column := range dataLog.columns {
+			values[i] = column(record)
+		}
+		stamp := record.Time
+		// The slot is free again once its values are copied out
+		atomic.StoreUint64(&dataLog.tail, tail+1)
+		if err := dataLog.writer.Add(stamp, values); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// Stops the writer after it has written everything committed so far, the writer is not closed
+func (dataLog *DataLog) Close() error {
+	close(dataLog.stop)
+	return <-dataLog.done
+}
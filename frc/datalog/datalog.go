@@ -0,0 +1,175 @@
+// Columnar log format for per-tick signals. A file starts with a schema naming every signal, then has blocks of
+// rows where each signal is stored as its own column, so one signal can be read without decoding the others.
+//
+// Times are microseconds and values are stored as multiples of their signal's resolution, both as zigzag varint
+// deltas from the row before, which takes a byte or two for anything that changes smoothly
+package datalog
+
+import (
+	"encoding/binary"
+	"errors"
+	"io"
+	"math"
+)
+
+type Type uint8
+
+const (
+	Float   Type = iota // Stored to the signal's resolution
+	Integer             // Stored exactly
+)
+
+type Signal struct {
+	Name       string
+	Units      string
+	Type       Type
+	Resolution float64 // Smallest step kept for a Float signal
+}
+
+// The header is followed by the number of signals, then each signal as its name, units, type and resolution.
+// Every block starts with its row count and the byte lengths of its events, of the time column and of each
+// signal's column, all as uint32, followed by those sections in the same order. Each event is its time as a varint
+// delta in microseconds, then its text with a uvarint length
+const (
+	header = "FRCLOG\x00\x02"
+
+	DefaultBlockRows = 500
+)
+
+var ErrNotDataLog = errors.New("datalog: not a data log")
+
+type Writer struct {
+	BlockRows int
+
+	writer    io.Writer
+	signals   []Signal
+	times     []byte
+	columns   [][]byte
+	rows      int
+	lastTime  int64
+	last      []int64
+	events    []byte
+	lastEvent int64
+	block     []byte
+}
+
+func NewWriter(w io.Writer, signals []Signal) (*Writer, error) {
+	writer := &Writer{
+		BlockRows: DefaultBlockRows,
+		writer:    w,
+		signals:   append([]Signal(nil), signals...),
+		columns:   make([][]byte, len(signals)),
+		last:      make([]int64, len(signals)),
+	}
+	buffer := append([]byte(header), 0, 0, 0, 0)
+	binary.LittleEndian.PutUint32(buffer[len(header):], uint32(len(signals)))
+	for _, signal := range signals {
+		buffer = appendString(buffer, signal.Name)
+		buffer = appendString(buffer, signal.Units)
+		buffer = append(buffer, byte(signal.Type), 0, 0, 0, 0, 0, 0, 0, 0)
+		binary.LittleEndian.PutUint64(buffer[len(buffer)-8:], math.Float64bits(signal.Resolution))
+	}
+	if _, err := w.Write(buffer); err != nil {
+		return nil, err
+	}
+	return writer, nil
+}
+
+func appendString(buffer []byte, s string) []byte {
+	buffer = append(buffer, 0, 0)
+	binary.LittleEndian.PutUint16(buffer[len(buffer)-2:], uint16(len(s)))
+	return append(buffer, s...)
+}
+
+// The integer a value is stored as, a multiple of the resolution for a Float signal
+func (signal *Signal) Quantize(value float64) int64 {
+	if signal.Type == Integer {
+		return int64(value)
+	}
+	if math.IsNaN(value) || signal.Resolution <= 0 {
+		return 0
+	}
+	return int64(math.Round(value / signal.Resolution))
+}
+
+// The value a stored integer stands for
+func (signal *Signal) Restore(stored int64) float64 {
+	if signal.Type == Integer {
+		return float64(stored)
+	}
+	// Dividing by a whole inverse gives 0.009 rather than 0.009000000000000001 for a resolution of 1e-3
+	if inverse := 1 / signal.Resolution; inverse == math.Round(inverse) {
+		return float64(stored) / inverse
+	}
+	return float64(stored) * signal.Resolution
+}
+
+// Adds a row with one value per signal in schema order, time in seconds. Blocks are written once they are full
+func (writer *Writer) Add(time float64, values []float64) error {
+	micros := int64(math.Round(time * 1e6))
+	if writer.rows == 0 {
+		writer.lastTime = 0
+		for i := range writer.last {
+			writer.last[i] = 0
+		}
+	}
+	writer.times = appendDelta(writer.times, micros, &writer.lastTime)
+	for i := range writer.signals {
+		writer.columns[i] = appendDelta(writer.columns[i], writer.signals[i].Quantize(values[i]), &writer.last[i])
+	}
+	writer.rows++
+	if writer.rows >= writer.BlockRows {
+		return writer.Flush()
+	}
+	return nil
+}
+
+func appendDelta(column []byte, value int64, last *int64) []byte {
+	var scratch [binary.MaxVarintLen64]byte
+	n := binary.PutVarint(scratch[:], value-*last)
+	*last = value
+	return append(column, scratch[:n]...)
+}
+
+// Adds a message such as an error from a device, written with the next block
+func (writer *Writer) Event(time float64, text string) {
+	if len(writer.events) == 0 {
+		writer.lastEvent = 0
+	}
+	writer.events = appendDelta(writer.events, int64(math.Round(time*1e6)), &writer.lastEvent)
+	var scratch [binary.MaxVarintLen64]byte
+	n := binary.PutUvarint(scratch[:], uint64(len(text)))
+	writer.events = append(append(writer.events, scratch[:n]...), text...)
+}
+
+// Writes the rows and events added so far as a block, with one Write call
+func (writer *Writer) Flush() error {
+	if writer.rows == 0 && len(writer.events) == 0 {
+		return nil
+	}
+	block := writer.block[:0]
+	block = appendUint32(block, uint32(writer.rows))
+	block = appendUint32(block, uint32(len(writer.events)))
+	block = appendUint32(block, uint32(len(writer.times)))
+	for _, column := range writer.columns {
+		block = appendUint32(block, uint32(len(column)))
+	}
+	block = append(block, writer.events...)
+	block = append(block, writer.times...)
+	for i, column := range writer.columns {
+		block = append(block, column...)
+		writer.columns[i] = column[:0]
+	}
+	writer.events = writer.events[:0]
+	writer.times = writer.times[:0]
+	writer.rows = 0
+	writer.block = block
+	_, err := writer.writer.Write(block)
+	return err
+}
+
+func appendUint32(buffer []byte, value uint32) []byte {
+	buffer = append(buffer, 0, 0, 0, 0)
+	binary.LittleEndian.PutUint32(buffer[len(buffer)-4:], value)
+	return buffer
+}
@@ -0,0 +1,183 @@
+package datalog
+
+import (
+	"bytes"
+	"math"
+	"testing"
+)
+
+var testSignals = []Signal{
+	{Name: "output", Resolution: 1e-3},
+	{Name: "position", Units: "m", Resolution: 1e-4},
+	{Name: "mode", Type: Integer},
+}
+
+// Smooth values, a jump every so often and both signs, so the deltas are small and large
+func testRow(i int) []float64 {
+	jump := 0.0
+	if i%17 == 0 {
+		jump = 1000
+	}
+	return []float64{math.Sin(float64(i)*0.1) + jump, -0.01234*float64(i) + 3, float64(i%5 - 2)}
+}
+
+// Writes rows at 50 Hz in blocks of blockRows, returning the file and its length after each block
+func writeTestLog(t *testing.T, rows, blockRows int) ([]byte, []int) {
+	var buffer bytes.Buffer
+	writer, err := NewWriter(&buffer, testSignals)
+	if err != nil {
+		t.Fatal(err)
+	}
+	writer.BlockRows = blockRows
+	var blockEnds []int
+	for i := 0; i < rows; i++ {
+		length := buffer.Len()
+		if err := writer.Add(float64(i)*0.02, testRow(i)); err != nil {
+			t.Fatal(err)
+		}
+		if buffer.Len() != length {
+			blockEnds = append(blockEnds, buffer.Len())
+		}
+	}
+	if err := writer.Flush(); err != nil {
+		t.Fatal(err)
+	}
+	if len(blockEnds) == 0 || blockEnds[len(blockEnds)-1] != buffer.Len() {
+		blockEnds = append(blockEnds, buffer.Len())
+	}
+	return buffer.Bytes(), blockEnds
+}
+
+func openTestLog(t *testing.T, file []byte) *Reader {
+	reader, err := NewReader(bytes.NewReader(file))
+	if err != nil {
+		t.Fatal(err)
+	}
+	return reader
+}
+
+// Checks rows from the first on, columns holding the signals given
+func checkRows(t *testing.T, times []float64, columns [][]float64, signals []int, rows int) {
+	t.Helper()
+	if len(times) != rows {
+		t.Fatalf("got %d rows, want %d", len(times), rows)
+	}
+	for i, time := range times {
+		if math.Abs(time-float64(i)*0.02) > 1e-6 {
+			t.Fatalf("row %d: time %g, want %g", i, time, float64(i)*0.02)
+		}
+		want := testRow(i)
+		for j, index := range signals {
+			if len(columns[j]) != rows {
+				t.Fatalf("%s has %d values, want %d", testSignals[index].Name, len(columns[j]), rows)
+			}
+			// Integers come back exactly, floats to half their resolution
+			if math.Abs(columns[j][i]-want[index]) > testSignals[index].Resolution/2+1e-9 {
+				t.Fatalf("row %d: %s is %g, want %g", i, testSignals[index].Name, columns[j][i], want[index])
+			}
+		}
+	}
+}
+
+func TestRoundTrip(t *testing.T) {
+	file, _ := writeTestLog(t, 120, DefaultBlockRows)
+	reader := openTestLog(t, file)
+	if len(reader.Signals) != len(testSignals) {
+		t.Fatalf("schema has %d signals, want %d", len(reader.Signals), len(testSignals))
+	}
+	for i, signal := range reader.Signals {
+		if signal != testSignals[i] {
+			t.Errorf("signal %d is %+v, want %+v", i, signal, testSignals[i])
+		}
+	}
+	times, columns, err := reader.Read(0, 1, 2)
+	if err != nil {
+		t.Fatal(err)
+	}
+	checkRows(t, times, columns, []int{0, 1, 2}, 120)
+}
+
+func TestEventsBetweenRows(t *testing.T) {
+	var buffer bytes.Buffer
+	writer, err := NewWriter(&buffer, testSignals)
+	if err != nil {
+		t.Fatal(err)
+	}
+	writer.BlockRows = 4
+	var want []Event
+	for i := 0; i < 20; i++ {
+		if i%3 == 0 {
+			event := Event{float64(i)*0.02 + 0.005, string(rune('a'+i)) + " failed"}
+			writer.Event(event.Time, event.Text)
+			want = append(want, event)
+		}
+		if err := writer.Add(float64(i)*0.02, testRow(i)); err != nil {
+			t.Fatal(err)
+		}
+	}
+	writer.Event(0.5, "after the last row")
+	want = append(want, Event{0.5, "after the last row"})
+	if err := writer.Flush(); err != nil {
+		t.Fatal(err)
+	}
+
+	reader := openTestLog(t, buffer.Bytes())
+	events, err := reader.Events()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(events) != len(want) {
+		t.Fatalf("got %d events, want %d", len(events), len(want))
+	}
+	for i, event := range events {
+		if event.Text != want[i].Text || math.Abs(event.Time-want[i].Time) > 1e-6 {
+			t.Errorf("event %d is %+v, want %+v", i, event, want[i])
+		}
+	}
+	// The events do not get in the way of the rows
+	times, columns, err := reader.Read(1)
+	if err != nil {
+		t.Fatal(err)
+	}
+	checkRows(t, times, columns, []int{1}, 20)
+}
+
+func TestReadOneColumn(t *testing.T) {
+	file, blockEnds := writeTestLog(t, 50, 7)
+	if len(blockEnds) != 8 {
+		t.Fatalf("wrote %d blocks, want 8", len(blockEnds))
+	}
+	reader := openTestLog(t, file)
+	for index := range testSignals {
+		times, columns, err := reader.Read(index)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if len(columns) != 1 {
+			t.Fatalf("got %d columns, want 1", len(columns))
+		}
+		checkRows(t, times, columns, []int{index}, 50)
+	}
+}
+
+// A robot losing power leaves the last block cut short anywhere, in its header or in any column
+func TestTruncatedBlock(t *testing.T) {
+	file, blockEnds := writeTestLog(t, 30, 10)
+	if len(blockEnds) != 3 {
+		t.Fatalf("wrote %d blocks, want 3", len(blockEnds))
+	}
+	for end := blockEnds[1] + 1; end < blockEnds[2]; end++ {
+		reader := openTestLog(t, file[:end])
+		times, columns, err := reader.Read(0, 2)
+		if err != nil {
+			t.Fatalf("cut at %d: %v", end, err)
+		}
+		checkRows(t, times, columns, []int{0, 2}, 20)
+	}
+}
+
+func TestNotDataLog(t *testing.T) {
+	if _, err := NewReader(bytes.NewReader([]byte("FRCLOG\x00\x01"))); err != ErrNotDataLog {
+		t.Errorf("got %v, want ErrNotDataLog", err)
+	}
+}
@@ -0,0 +1,212 @@
+package datalog
+
+import (
+	"encoding/binary"
+	"io"
+	"math"
+)
+
+// Reads a log one column at a time, so extracting a signal does not decode the others
+type Reader struct {
+	Signals []Signal
+
+	reader    io.ReadSeeker
+	dataStart int64
+}
+
+func NewReader(r io.ReadSeeker) (*Reader, error) {
+	prefix := make([]byte, len(header)+4)
+	if _, err := io.ReadFull(r, prefix); err != nil || string(prefix[:len(header)]) != header {
+		return nil, ErrNotDataLog
+	}
+	count := int(binary.LittleEndian.Uint32(prefix[len(header):]))
+	reader := &Reader{reader: r, Signals: make([]Signal, count)}
+	for i := range reader.Signals {
+		signal := &reader.Signals[i]
+		var err error
+		if signal.Name, err = readString(r); err != nil {
+			return nil, ErrNotDataLog
+		}
+		if signal.Units, err = readString(r); err != nil {
+			return nil, ErrNotDataLog
+		}
+		var typeAndResolution [9]byte
+		if _, err := io.ReadFull(r, typeAndResolution[:]); err != nil {
+			return nil, ErrNotDataLog
+		}
+		signal.Type = Type(typeAndResolution[0])
+		signal.Resolution = math.Float64frombits(binary.LittleEndian.Uint64(typeAndResolution[1:]))
+	}
+	start, err := r.Seek(0, io.SeekCurrent)
+	if err != nil {
+		return nil, err
+	}
+	reader.dataStart = start
+	return reader, nil
+}
+
+func readString(r io.Reader) (string, error) {
+	var length [2]byte
+	if _, err := io.ReadFull(r, length[:]); err != nil {
+		return "", err
+	}
+	s := make([]byte, binary.LittleEndian.Uint16(length[:]))
+	_, err := io.ReadFull(r, s)
+	return string(s), err
+}
+
+// Index of the named signal, -1 if the log does not have it
+func (reader *Reader) Find(name string) int {
+	for i, signal := range reader.Signals {
+		if signal.Name == name {
+			return i
+		}
+	}
+	return -1
+}
+
+// Times in seconds and the values of the given signals. Only the time column and the columns asked for are read,
+// the rest of every block is skipped over. A block cut short by the robot losing power ends the log
+func (reader *Reader) Read(signals ...int) (times []float64, columns [][]float64, err error) {
+	if _, err := reader.reader.Seek(reader.dataStart, io.SeekStart); err != nil {
+		return nil, nil, err
+	}
+	columns = make([][]float64, len(signals))
+	lengths := make([]uint32, 3+len(reader.Signals))
+	var raw []byte
+	for {
+		rows, err := reader.readBlockHeader(lengths)
+		if err != nil {
+			return times, columns, nil
+		}
+		blockStart, err := reader.reader.Seek(0, io.SeekCurrent)
+		if err != nil {
+			return nil, nil, err
+		}
+		offsets := make([]int64, len(lengths))
+		offset := blockStart
+		for i := 1; i < len(lengths); i++ {
+			offsets[i] = offset
+			offset += int64(lengths[i])
+		}
+		// Everything is decoded before any of it is kept, so a truncated block is left out as a whole
+		if raw, err = reader.readColumn(raw, offsets[2], lengths[2]); err != nil {
+			return times, columns, nil
+		}
+		blockTimes := decodeColumn(raw, rows)
+		blockColumns := make([][]int64, len(signals))
+		complete := len(blockTimes) == rows
+		for i, index := range signals {
+			if !complete {
+				break
+			}
+			if raw, err = reader.readColumn(raw, offsets[3+index], lengths[3+index]); err != nil {
+				complete = false
+				break
+			}
+			blockColumns[i] = decodeColumn(raw, rows)
+			complete = len(blockColumns[i]) == rows
+		}
+		if !complete {
+			return times, columns, nil
+		}
+		for _, micros := range blockTimes {
+			times = append(times, float64(micros)*1e-6)
+		}
+		for i, index := range signals {
+			for _, stored := range blockColumns[i] {
+				columns[i] = append(columns[i], reader.Signals[index].Restore(stored))
+			}
+		}
+		if _, err := reader.reader.Seek(offset, io.SeekStart); err != nil {
+			return nil, nil, err
+		}
+	}
+}
+
+// A message logged between rows, such as an error from a device
+type Event struct {
+	Time float64
+	Text string
+}
+
+// Every event in the log, reading only the event section of each block
+func (reader *Reader) Events() ([]Event, error) {
+	if _, err := reader.reader.Seek(reader.dataStart, io.SeekStart); err != nil {
+		return nil, err
+	}
+	var events []Event
+	lengths := make([]uint32, 3+len(reader.Signals))
+	var raw []byte
+	for {
+		if _, err := reader.readBlockHeader(lengths); err != nil {
+			return events, nil
+		}
+		blockStart, err := reader.reader.Seek(0, io.SeekCurrent)
+		if err != nil {
+			return nil, err
+		}
+		if raw, err = reader.readColumn(raw, blockStart, lengths[1]); err != nil {
+			return events, nil
+		}
+		last := int64(0)
+		for len(raw) > 0 {
+			delta, n := binary.Varint(raw)
+			if n <= 0 {
+				break
+			}
+			length, m := binary.Uvarint(raw[n:])
+			if m <= 0 || uint64(len(raw)-n-m) < length {
+				break
+			}
+			last += delta
+			events = append(events, Event{float64(last) * 1e-6, string(raw[n+m : n+m+int(length)])})
+			raw = raw[n+m+int(length):]
+		}
+		skip := int64(0)
+		for _, length := range lengths[2:] {
+			skip += int64(length)
+		}
+		if _, err := reader.reader.Seek(blockStart+int64(lengths[1])+skip, io.SeekStart); err != nil {
+			return nil, err
+		}
+	}
+}
+
+func (reader *Reader) readBlockHeader(lengths []uint32) (int, error) {
+	buffer := make([]byte, 4*len(lengths))
+	if _, err := io.ReadFull(reader.reader, buffer); err != nil {
+		return 0, err
+	}
+	for i := range lengths {
+		lengths[i] = binary.LittleEndian.Uint32(buffer[4*i:])
+	}
+	return int(lengths[0]), nil
+}
+
+func (reader *Reader) readColumn(buffer []byte, offset int64, length uint32) ([]byte, error) {
+	if _, err := reader.reader.Seek(offset, io.SeekStart); err != nil {
+		return buffer, err
+	}
+	if cap(buffer) < int(length) {
+		buffer = make([]byte, length)
+	}
+	buffer = buffer[:length]
+	_, err := io.ReadFull(reader.reader, buffer)
+	return buffer, err
+}
+
+func decodeColumn(raw []byte, rows int) []int64 {
+	values := make([]int64, 0, rows)
+	last := int64(0)
+	for len(values) < rows {
+		delta, n := binary.Varint(raw)
+		if n <= 0 {
+			break
+		}
+		raw = raw[n:]
+		last += delta
+		values = append(values, last)
+	}
+	return values
+}
@@ -0,0 +1,124 @@
+package drive
+
+// One update of the estimator, kept so a late vision measurement can be applied where it was taken
+type poseSample struct {
+	time              float64
+	left, right, gyro float64
+	pose              Pose
+}
+
+// Odometry corrected by vision. Cameras see the field some tens of milliseconds before their result arrives, so
+// each update is kept in a history. A measurement is blended into the pose from the time it was taken, and the
+// updates since are replayed on top of the corrected pose
+type PoseEstimator struct {
+	Odometry DifferentialOdometry
+	// How uncertain each source is in X, Y and heading. The smaller vision's are next to odometry's, the further a
+	// measurement pulls the pose, with equal ones moving it halfway
+	OdometryStdDevs, VisionStdDevs Pose
+
+	history []poseSample // Ring, oldest at start
+	start   int
+	count   int
+}
+
+// Keeps the last samples updates, which needs to cover the longest vision delay at the rate Update is called
+func NewPoseEstimator(samples int) *PoseEstimator {
+	return &PoseEstimator{
+		OdometryStdDevs: Pose{X: 0.05, Y: 0.05, Heading: 0.01},
+		VisionStdDevs:   Pose{X: 0.5, Y: 0.5, Heading: 0.5},
+		history:         make([]poseSample, samples),
+	}
+}
+
+// Forgets the history and starts over from pose, see DifferentialOdometry.Reset
+func (estimator *PoseEstimator) Reset(pose Pose, left, right, gyro float64) {
+	estimator.Odometry.Reset(pose, left, right, gyro)
+	estimator.start, estimator.count = 0, 0
+}
+
+// Moves the pose on by the readings taken at time, in seconds on the same clock as vision measurements
+func (estimator *PoseEstimator) Update(time, left, right, gyro float64) Pose {
+	pose := estimator.Odometry.Update(left, right, gyro)
+	var sample *poseSample
+	if estimator.count < len(estimator.history) {
+		sample = estimator.at(estimator.count)
+		estimator.count++
+	} else {
+		sample = estimator.at(0)
+		estimator.start = (estimator.start + 1) % len(estimator.history)
+	}
+	*sample = poseSample{time, left, right, gyro, pose}
+	return pose
+}
+
+func (estimator *PoseEstimator) Pose() Pose {
+	return estimator.Odometry.Pose
+}
+
+func (estimator *PoseEstimator) at(i int) *poseSample {
+	return &estimator.history[(estimator.start+i)%len(estimator.history)]
+}
+
+// Blends in a pose seen by vision at time. False when that is older than the history, the measurement is then
+// ignored. Costs one odometry step for every update since time
+func (estimator *PoseEstimator) AddVision(time float64, measured Pose) bool {
+	if estimator.count == 0 || time < estimator.at(0).time {
+		return false
+	}
+	// The first sample after time, by binary search
+	low, high := 0, estimator.count
+	for low < high {
+		middle := (low + high) / 2
+		if estimator.at(middle).time <= time {
+			low = middle + 1
+		} else {
+			high = middle
+		}
+	}
+	// What odometry read at time, between the samples either side of it
+	before := estimator.at(low - 1)
+	then := *before
+	if low < estimator.count {
+		after := estimator.at(low)
+		t := (time - before.time) / (after.time - before.time)
+		then.left += (after.left - before.left) * t
+		then.right += (after.right - before.right) * t
+		then.gyro += (after.gyro - before.gyro) * t
+		then.pose = before.pose.Interpolate(after.pose, t)
+	}
+
+	odometryStdDevs, visionStdDevs := &estimator.OdometryStdDevs, &estimator.VisionStdDevs
+	gains := Pose{
+		X:       gain(odometryStdDevs.X, visionStdDevs.X),
+		Y:       gain(odometryStdDevs.Y, visionStdDevs.Y),
+		Heading: gain(odometryStdDevs.Heading, visionStdDevs.Heading),
+	}
+	corrected := Pose{
+		X:       then.pose.X + gains.X*(measured.X-then.pose.X),
+		Y:       then.pose.Y + gains.Y*(measured.Y-then.pose.Y),
+		Heading: then.pose.Heading + gains.Heading*AngleDifference(measured.Heading, then.pose.Heading),
+	}
+
+	// Replay the updates since on top of the correction, which moves the gyro offset along with the heading
+	odometry := &estimator.Odometry
+	odometry.gyroOffset = corrected.Heading - then.gyro
+	pose := corrected
+	left, right := then.left, then.right
+	for i := low; i < estimator.count; i++ {
+		sample := estimator.at(i)
+		pose = odometry.step(pose, sample.left-left, sample.right-right, sample.gyro)
+		sample.pose = pose
+		left, right = sample.left, sample.right
+	}
+	odometry.Pose = pose
+	return true
+}
+
+// How far a measurement moves the estimate, from the variances of the estimate and of the measurement
+func gain(estimateStdDev, measurementStdDev float64) float64 {
+	estimate, measurement := estimateStdDev*estimateStdDev, measurementStdDev*measurementStdDev
+	if estimate+measurement == 0 {
+		return 0
+	}
+	return estimate / (estimate + measurement)
+}
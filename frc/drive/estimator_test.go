@@ -0,0 +1,148 @@
+package drive
+
+import (
+	"math"
+	"testing"
+)
+
+// Updates every 5 ms, as the path follower does
+const estimatorDt = 0.005
+
+func checkPose(t *testing.T, name string, got, want Pose, tolerance float64) {
+	t.Helper()
+	if math.Abs(got.X-want.X) > tolerance || math.Abs(got.Y-want.Y) > tolerance ||
+		math.Abs(AngleDifference(got.Heading, want.Heading)) > tolerance {
+		t.Errorf("%s is %+v, want %+v", name, got, want)
+	}
+}
+
+// A drive whose centre travels along an arc of the given curvature from start, zero for a straight line. The gyro
+// reads the heading turned since the start, and both sides read the distance, which is all odometry uses
+func TestOdometry(t *testing.T) {
+	tests := []struct {
+		name      string
+		start     Pose
+		curvature float64 // Per meter, positive to the left
+	}{
+		{"straight", Pose{}, 0},
+		{"straight from a pose", Pose{X: 1, Y: -2, Heading: 0.75}, 0},
+		{"arc to the left", Pose{}, 0.5},
+		{"arc to the right", Pose{X: 3, Y: 1, Heading: -2}, -1.25},
+	}
+	for _, test := range tests {
+		t.Run(test.name, func(t *testing.T) {
+			estimator := NewPoseEstimator(10)
+			estimator.Reset(test.start, 0, 0, 0)
+			var pose Pose
+			for i := 1; i <= 400; i++ {
+				distance := float64(i) * estimatorDt
+				pose = estimator.Update(float64(i)*estimatorDt, distance, distance, distance*test.curvature)
+			}
+			// Two meters along the arc, in the frame of the start pose
+			distance, turned := 2.0, 2*test.curvature
+			local := Pose{X: distance, Heading: turned}
+			if test.curvature != 0 {
+				local = Pose{X: math.Sin(turned) / test.curvature, Y: (1 - math.Cos(turned)) / test.curvature, Heading: turned}
+			}
+			sin, cos := math.Sincos(test.start.Heading)
+			want := Pose{
+				X:       test.start.X + local.X*cos - local.Y*sin,
+				Y:       test.start.Y + local.X*sin + local.Y*cos,
+				Heading: test.start.Heading + turned,
+			}
+			checkPose(t, "pose", pose, want, 1e-9)
+		})
+	}
+}
+
+// Drives straight along X at 1 m/s for a second with encoders that read 10% long, so odometry drifts ahead
+func driftingEstimator(samples int) *PoseEstimator {
+	estimator := NewPoseEstimator(samples)
+	estimator.Reset(Pose{}, 0, 0, 0)
+	for i := 1; i <= 200; i++ {
+		time := float64(i) * estimatorDt
+		estimator.Update(time, 1.1*time, 1.1*time, 0)
+	}
+	return estimator
+}
+
+// The true pose seen late, between two updates, pulls the pose by the gain towards where the robot was, and the
+// updates since are replayed from there
+func TestAddVisionLateMeasurement(t *testing.T) {
+	estimator := driftingEstimator(400)
+	gains := Pose{
+		X:       gain(estimator.OdometryStdDevs.X, estimator.VisionStdDevs.X),
+		Heading: gain(estimator.OdometryStdDevs.Heading, estimator.VisionStdDevs.Heading),
+	}
+	before := estimator.Pose()
+	seen := 0.5025 // Halfway between two updates, where odometry read 1.1 times as far
+	if !estimator.AddVision(seen, Pose{X: seen}) {
+		t.Fatal("measurement within the history was rejected")
+	}
+	shift := gains.X * (seen - 1.1*seen)
+	checkPose(t, "pose", estimator.Pose(), Pose{X: before.X + shift}, 1e-9)
+
+	// The history now holds the corrected poses, so a measurement of exactly those moves nothing
+	if !estimator.AddVision(0.75, Pose{X: 1.1*0.75 + shift}) {
+		t.Fatal("second measurement was rejected")
+	}
+	checkPose(t, "pose after a measurement of the corrected pose", estimator.Pose(), Pose{X: before.X + shift}, 1e-9)
+
+	// A heading seen late turns the replayed updates and stays once odometry carries on with the same gyro
+	turn := gains.Heading * 0.2
+	if !estimator.AddVision(0.9, Pose{X: 1.1*0.9 + shift, Heading: 0.2}) {
+		t.Fatal("third measurement was rejected")
+	}
+	pose := estimator.Pose()
+	if math.Abs(pose.Heading-turn) > 1e-9 {
+		t.Errorf("heading %g, want %g", pose.Heading, turn)
+	}
+	if want := 0.1 * 1.1 * math.Sin(turn); math.Abs(pose.Y-want) > 1e-9 {
+		t.Errorf("y %g after replaying 100 ms at the new heading, want %g", pose.Y, want)
+	}
+	next := estimator.Update(1.005, 1.1*1.005, 1.1*1.005, 0)
+	if math.Abs(next.Heading-turn) > 1e-9 {
+		t.Errorf("heading %g after the next update, want %g", next.Heading, turn)
+	}
+}
+
+func TestAddVisionOutsideHistory(t *testing.T) {
+	if NewPoseEstimator(10).AddVision(0, Pose{}) {
+		t.Error("accepted a measurement with no history")
+	}
+	estimator := driftingEstimator(20) // Keeps the updates from 0.905 s on
+	before := estimator.Pose()
+	for _, time := range []float64{0, 0.5, 0.9} {
+		if estimator.AddVision(time, Pose{X: 5}) {
+			t.Errorf("accepted a measurement from %gs, older than the history", time)
+		}
+	}
+	checkPose(t, "pose after rejected measurements", estimator.Pose(), before, 0)
+	if !estimator.AddVision(0.905, Pose{X: 5}) {
+		t.Error("rejected a measurement from the oldest update kept")
+	}
+}
+
+// One odometry update at 200 Hz on a drive going round in circles
+func BenchmarkPoseEstimator(b *testing.B) {
+	estimator := NewPoseEstimator(400)
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		time := float64(i) * 0.005
+		estimator.Update(time, time, time*1.1, time*0.2)
+	}
+}
+
+// A camera result 100 ms late at 200 Hz, so every measurement replays 20 updates
+func BenchmarkPoseEstimatorVision(b *testing.B) {
+	estimator := NewPoseEstimator(400)
+	for i := 0; i < 400; i++ {
+		time := float64(i) * 0.005
+		estimator.Update(time, time, time*1.1, time*0.2)
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		estimator.AddVision(1.9, Pose{X: 1, Y: float64(i & 1), Heading: 0.4})
+	}
+}
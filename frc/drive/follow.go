@@ -0,0 +1,66 @@
+package drive
+
+import "math"
+
+// Steers a drive along a trajectory, giving the speed in meters per second and turn rate in radians per second
+// for a robot at pose, time seconds into the trajectory
+type PathController interface {
+	Calculate(trajectory *Trajectory, time float64, pose Pose) (velocity, omega float64)
+}
+
+// Follows the trajectory's reference state with feedback on the error in the robot's frame. B above zero makes it
+// converge harder like a proportional gain, Zeta between zero and one damps it. 2 and 0.7 suit most robots
+type Ramsete struct {
+	B, Zeta float64
+}
+
+func (ramsete *Ramsete) Calculate(trajectory *Trajectory, time float64, pose Pose) (float64, float64) {
+	reference := trajectory.Sample(time)
+	sin, cos := math.Sincos(pose.Heading)
+	dx, dy := reference.Pose.X-pose.X, reference.Pose.Y-pose.Y
+	errorX, errorY := cos*dx+sin*dy, -sin*dx+cos*dy
+	errorHeading := AngleDifference(reference.Pose.Heading, pose.Heading)
+	velocity, omega := reference.Velocity, reference.Velocity*reference.Curvature
+	k := 2 * ramsete.Zeta * math.Sqrt(omega*omega+ramsete.B*velocity*velocity)
+	return velocity*math.Cos(errorHeading) + k*errorX,
+		omega + k*errorHeading + ramsete.B*velocity*sinc(errorHeading)*errorY
+}
+
+func sinc(x float64) float64 {
+	if math.Abs(x) < 1e-9 {
+		return 1 - x*x/6
+	}
+	return math.Sin(x) / x
+}
+
+// Steers for the arc through the first point of the trajectory at least Lookahead meters away, starting from the
+// state at time and driving at that state's speed. Longer lookaheads cut corners but do not oscillate
+type PurePursuit struct {
+	Lookahead float64
+}
+
+func (pursuit *PurePursuit) Calculate(trajectory *Trajectory, time float64, pose Pose) (float64, float64) {
+	states := trajectory.States
+	if len(states) == 0 {
+		return 0, 0
+	}
+	i := trajectory.index(time)
+	for i+1 < len(states) &&
+		math.Hypot(states[i].Pose.X-pose.X, states[i].Pose.Y-pose.Y) < pursuit.Lookahead {
+		i++
+	}
+	sin, cos := math.Sincos(pose.Heading)
+	dx, dy := states[i].Pose.X-pose.X, states[i].Pose.Y-pose.Y
+	lateral := -sin*dx + cos*dy
+	velocity := trajectory.Sample(time).Velocity
+	distanceSquared := dx*dx + dy*dy
+	if distanceSquared == 0 {
+		return velocity, 0
+	}
+	return velocity, velocity * 2 * lateral / distanceSquared
+}
+
+// Left and right wheel speeds of a tank drive moving at velocity and turning at omega
+func DifferentialWheelSpeeds(velocity, omega, trackWidth float64) (left, right float64) {
+	return velocity - omega*trackWidth/2, velocity + omega*trackWidth/2
+}
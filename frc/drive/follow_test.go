@@ -0,0 +1,43 @@
+package drive
+
+import "testing"
+
+// An S across the field, a few hundred states
+func benchTrajectory() *Trajectory {
+	return GenerateTrajectory([]Pose{{X: 0, Y: 0}, {X: 3, Y: 1.5}, {X: 6, Y: 0, Heading: -0.5}},
+		TrajectoryConfig{MaxVelocity: 3, MaxAcceleration: 2, MaxCentripetal: 2})
+}
+
+func BenchmarkTrajectorySample(b *testing.B) {
+	trajectory := benchTrajectory()
+	duration := trajectory.Duration()
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		trajectory.Sample(float64(i%1000) / 1000 * duration)
+	}
+}
+
+// One run of a follower, with the robot a little off the trajectory wherever it is
+func BenchmarkPathController(b *testing.B) {
+	controllers := []struct {
+		name       string
+		controller PathController
+	}{
+		{"Ramsete", &Ramsete{B: 2, Zeta: 0.7}},
+		{"PurePursuit", &PurePursuit{Lookahead: 0.5}},
+	}
+	trajectory := benchTrajectory()
+	duration := trajectory.Duration()
+	for _, test := range controllers {
+		b.Run(test.name, func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				time := float64(i%1000) / 1000 * duration
+				pose := trajectory.Sample(time).Pose
+				pose.X += 0.05
+				test.controller.Calculate(trajectory, time, pose)
+			}
+		})
+	}
+}
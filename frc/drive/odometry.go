@@ -0,0 +1,30 @@
+package drive
+
+// Tracks a tank drive's pose from the distance each side has travelled and a gyro. The gyro gives the heading, since
+// wheels slip sideways when turning and so drift in heading much faster than in distance
+type DifferentialOdometry struct {
+	Pose Pose
+
+	left, right, gyro float64 // Readings at the last update
+	gyroOffset        float64 // Pose heading minus gyro reading
+}
+
+// Starts tracking from pose with the current readings, distances in meters and the gyro in radians counter clockwise
+func (odometry *DifferentialOdometry) Reset(pose Pose, left, right, gyro float64) {
+	odometry.Pose = pose
+	odometry.left, odometry.right, odometry.gyro = left, right, gyro
+	odometry.gyroOffset = pose.Heading - gyro
+}
+
+func (odometry *DifferentialOdometry) Update(left, right, gyro float64) Pose {
+	odometry.Pose = odometry.step(odometry.Pose, left-odometry.left, right-odometry.right, gyro)
+	odometry.left, odometry.right, odometry.gyro = left, right, gyro
+	return odometry.Pose
+}
+
+func (odometry *DifferentialOdometry) step(pose Pose, dLeft, dRight, gyro float64) Pose {
+	heading := gyro + odometry.gyroOffset
+	next := pose.Exp(Twist{Dx: (dLeft + dRight) / 2, DHeading: heading - pose.Heading})
+	next.Heading = heading
+	return next
+}
@@ -0,0 +1,55 @@
+// Where the robot is on the field: poses, odometry and a pose estimator that folds in vision. Everything here is
+// plain values and preallocated state, so updating it every tick never allocates
+package drive
+
+import "math"
+
+// Field position in meters and heading in radians counter clockwise
+type Pose struct {
+	X, Y, Heading float64
+}
+
+// Motion in the robot's own frame, forward along Dx, left along Dy, turning DHeading
+type Twist struct {
+	Dx, Dy, DHeading float64
+}
+
+// Where the robot ends up moving along twist on an arc of constant curvature, which is exact for a drive whose wheel
+// speeds were steady over the step, unlike adding the motion along the starting heading
+func (pose Pose) Exp(twist Twist) Pose {
+	sin, cos := math.Sincos(twist.DHeading)
+	var sinTerm, cosTerm float64
+	if math.Abs(twist.DHeading) < 1e-9 {
+		sinTerm = 1 - twist.DHeading*twist.DHeading/6
+		cosTerm = twist.DHeading / 2
+	} else {
+		sinTerm = sin / twist.DHeading
+		cosTerm = (1 - cos) / twist.DHeading
+	}
+	dx := twist.Dx*sinTerm - twist.Dy*cosTerm
+	dy := twist.Dx*cosTerm + twist.Dy*sinTerm
+	headingSin, headingCos := math.Sincos(pose.Heading)
+	return Pose{
+		X:       pose.X + dx*headingCos - dy*headingSin,
+		Y:       pose.Y + dx*headingSin + dy*headingCos,
+		Heading: pose.Heading + twist.DHeading,
+	}
+}
+
+// The pose a fraction t of the way from pose to other, turning the short way round
+func (pose Pose) Interpolate(other Pose, t float64) Pose {
+	return Pose{
+		X:       pose.X + (other.X-pose.X)*t,
+		Y:       pose.Y + (other.Y-pose.Y)*t,
+		Heading: pose.Heading + AngleDifference(other.Heading, pose.Heading)*t,
+	}
+}
+
+// a minus b wrapped into [-π, π)
+func AngleDifference(a, b float64) float64 {
+	difference := math.Mod(a-b+math.Pi, 2*math.Pi)
+	if difference < 0 {
+		difference += 2 * math.Pi
+	}
+	return difference - math.Pi
+}
@@ -0,0 +1,110 @@
+package drive
+
+import "math"
+
+// Velocity of the robot in its own frame, meters per second forward and left and radians per second counter clockwise
+type ChassisSpeeds struct {
+	Vx, Vy, Omega float64
+}
+
+// Speeds given relative to the field, turned into the frame of a robot with the given heading
+func FieldRelative(speeds ChassisSpeeds, heading float64) ChassisSpeeds {
+	sin, cos := math.Sincos(heading)
+	return ChassisSpeeds{
+		Vx:    speeds.Vx*cos + speeds.Vy*sin,
+		Vy:    -speeds.Vx*sin + speeds.Vy*cos,
+		Omega: speeds.Omega,
+	}
+}
+
+// Modules of a swerve drive, each at X meters forward and Y meters left of the center of rotation. Module states
+// are kept in parallel slices, one element per module, which the caller allocates once: speeds in meters per second
+// and angles in radians counter clockwise from forward
+type SwerveKinematics struct {
+	X, Y []float64
+}
+
+// The speed and direction of every module for the robot to move at chassis
+func (kinematics *SwerveKinematics) ToModuleStates(chassis ChassisSpeeds, speeds, angles []float64) {
+	x, y := kinematics.X, kinematics.Y
+	if len(x) == 0 {
+		return
+	}
+	_, _, _ = y[len(x)-1], speeds[len(x)-1], angles[len(x)-1]
+	for i := range x {
+		vx := chassis.Vx - chassis.Omega*y[i]
+		vy := chassis.Vy + chassis.Omega*x[i]
+		speeds[i] = math.Hypot(vx, vy)
+		angles[i] = math.Atan2(vy, vx)
+	}
+}
+
+// How the robot moves with its modules at these speeds and angles, the least squares fit when the modules disagree
+func (kinematics *SwerveKinematics) ToChassisSpeeds(speeds, angles []float64) ChassisSpeeds {
+	x, y := kinematics.X, kinematics.Y
+	if len(x) == 0 {
+		return ChassisSpeeds{}
+	}
+	count := float64(len(x))
+	var centerX, centerY, meanVx, meanVy float64
+	for i := range x {
+		sin, cos := math.Sincos(angles[i])
+		centerX += x[i]
+		centerY += y[i]
+		meanVx += speeds[i] * cos
+		meanVy += speeds[i] * sin
+	}
+	centerX, centerY, meanVx, meanVy = centerX/count, centerY/count, meanVx/count, meanVy/count
+	// Turning is what is left of each module's velocity around the centroid of the modules
+	var moment, inertia float64
+	for i := range x {
+		sin, cos := math.Sincos(angles[i])
+		dx, dy := x[i]-centerX, y[i]-centerY
+		moment += dx*speeds[i]*sin - dy*speeds[i]*cos
+		inertia += dx*dx + dy*dy
+	}
+	omega := 0.0
+	if inertia > 0 {
+		omega = moment / inertia
+	}
+	return ChassisSpeeds{Vx: meanVx + omega*centerY, Vy: meanVy - omega*centerX, Omega: omega}
+}
+
+// Scales all speeds down together so none is above max, which keeps the direction the robot moves in
+func DesaturateWheelSpeeds(speeds []float64, max float64) {
+	highest := 0.0
+	for _, speed := range speeds {
+		highest = math.Max(highest, math.Abs(speed))
+	}
+	if highest > max {
+		scale := max / highest
+		for i := range speeds {
+			speeds[i] *= scale
+		}
+	}
+}
+
+// Changes each target angle into the one nearest the module's current angle that gives the same motion, reversing
+// the wheel instead of turning the module more than a quarter turn. Current angles are unwrapped, as a module's
+// sensor counts them, and so are the results. A module that is not moving keeps its angle
+func OptimizeModuleStates(speeds, angles, current []float64) {
+	if len(speeds) == 0 {
+		return
+	}
+	_, _ = angles[len(speeds)-1], current[len(speeds)-1]
+	for i := range speeds {
+		if speeds[i] == 0 {
+			angles[i] = current[i]
+			continue
+		}
+		turn := AngleDifference(angles[i], current[i])
+		if turn > math.Pi/2 {
+			turn -= math.Pi
+			speeds[i] = -speeds[i]
+		} else if turn < -math.Pi/2 {
+			turn += math.Pi
+			speeds[i] = -speeds[i]
+		}
+		angles[i] = current[i] + turn
+	}
+}
@@ -0,0 +1,122 @@
+package drive
+
+import (
+	"math"
+	"testing"
+)
+
+// Four modules at the corners of a 60 cm square
+var squareModules = SwerveKinematics{X: []float64{0.3, 0.3, -0.3, -0.3}, Y: []float64{0.3, -0.3, 0.3, -0.3}}
+
+func TestToModuleStates(t *testing.T) {
+	quarter, eighth := math.Pi/2, math.Pi/4
+	radius := 0.3 * math.Sqrt2
+	tests := []struct {
+		name                   string
+		chassis                ChassisSpeeds
+		wantSpeeds, wantAngles []float64
+	}{
+		{"forward", ChassisSpeeds{Vx: 2}, []float64{2, 2, 2, 2}, []float64{0, 0, 0, 0}},
+		{"left", ChassisSpeeds{Vy: 1.5}, []float64{1.5, 1.5, 1.5, 1.5}, []float64{quarter, quarter, quarter, quarter}},
+		{"diagonal", ChassisSpeeds{Vx: 1, Vy: -1}, []float64{math.Sqrt2, math.Sqrt2, math.Sqrt2, math.Sqrt2},
+			[]float64{-eighth, -eighth, -eighth, -eighth}},
+		// Every module at a right angle to the line from the center, counter clockwise
+		{"turning on the spot", ChassisSpeeds{Omega: 2}, []float64{2 * radius, 2 * radius, 2 * radius, 2 * radius},
+			[]float64{3 * eighth, eighth, -3 * eighth, -eighth}},
+		{"still", ChassisSpeeds{}, []float64{0, 0, 0, 0}, []float64{0, 0, 0, 0}},
+	}
+	speeds, angles := make([]float64, 4), make([]float64, 4)
+	for _, test := range tests {
+		t.Run(test.name, func(t *testing.T) {
+			squareModules.ToModuleStates(test.chassis, speeds, angles)
+			for i := range speeds {
+				turned := AngleDifference(angles[i], test.wantAngles[i])
+				if math.Abs(speeds[i]-test.wantSpeeds[i]) > 1e-12 || math.Abs(turned) > 1e-12 {
+					t.Errorf("module %d at %g m/s and %g rad, want %g m/s and %g rad", i, speeds[i], angles[i],
+						test.wantSpeeds[i], test.wantAngles[i])
+				}
+			}
+		})
+	}
+}
+
+// Forward kinematics undo inverse kinematics, also with the center of rotation away from the middle of the modules
+func TestModuleStatesRoundTrip(t *testing.T) {
+	offCenter := SwerveKinematics{X: []float64{0.5, 0.5, -0.1, -0.1}, Y: []float64{0.4, -0.2, 0.4, -0.2}}
+	chassisSpeeds := []ChassisSpeeds{{Vx: 2}, {Omega: -3}, {Vx: 1, Vy: -0.5, Omega: 2}, {Vx: -4, Vy: 3, Omega: 0.1}}
+	for _, kinematics := range []SwerveKinematics{squareModules, offCenter} {
+		for _, chassis := range chassisSpeeds {
+			speeds, angles := make([]float64, 4), make([]float64, 4)
+			kinematics.ToModuleStates(chassis, speeds, angles)
+			got := kinematics.ToChassisSpeeds(speeds, angles)
+			if math.Abs(got.Vx-chassis.Vx) > 1e-9 || math.Abs(got.Vy-chassis.Vy) > 1e-9 ||
+				math.Abs(got.Omega-chassis.Omega) > 1e-9 {
+				t.Errorf("modules at %v: %+v came back as %+v", kinematics.X, chassis, got)
+			}
+		}
+	}
+}
+
+func TestDesaturateWheelSpeeds(t *testing.T) {
+	tests := []struct {
+		name   string
+		speeds []float64
+		max    float64
+		want   []float64
+	}{
+		{"under the limit", []float64{1, -2, 3, 0.5}, 4, []float64{1, -2, 3, 0.5}},
+		{"at the limit", []float64{4, -1, 2, 3}, 4, []float64{4, -1, 2, 3}},
+		{"above the limit", []float64{2, 8, -4, 6}, 4, []float64{1, 4, -2, 3}},
+		{"reversing above the limit", []float64{-10, 5, 2.5, -5}, 5, []float64{-5, 2.5, 1.25, -2.5}},
+	}
+	for _, test := range tests {
+		t.Run(test.name, func(t *testing.T) {
+			speeds := append([]float64(nil), test.speeds...)
+			DesaturateWheelSpeeds(speeds, test.max)
+			for i := range speeds {
+				if math.Abs(speeds[i]-test.want[i]) > 1e-12 {
+					t.Errorf("speeds %v, want %v", speeds, test.want)
+					break
+				}
+			}
+			// Every module keeps its share of the fastest one, so the robot still moves the same way
+			for i := 1; i < len(speeds); i++ {
+				if math.Abs(speeds[i]*test.speeds[0]-speeds[0]*test.speeds[i]) > 1e-9 {
+					t.Errorf("ratio of module %d to module 0 changed", i)
+				}
+			}
+		})
+	}
+}
+
+func TestOptimizeModuleStates(t *testing.T) {
+	tests := []struct {
+		name                 string
+		speed, angle         float64
+		current              float64 // Unwrapped, as the module's sensor counts it
+		wantSpeed, wantAngle float64
+	}{
+		{"small turn", 1, 0.5, 0, 1, 0.5},
+		{"just under a quarter turn", 1, math.Pi/2 - 0.01, 0, 1, math.Pi/2 - 0.01},
+		{"past a quarter turn", 1, 3 * math.Pi / 4, 0, -1, -math.Pi / 4},
+		{"past a quarter turn the other way", 2, -3 * math.Pi / 4, 0, -2, math.Pi / 4},
+		{"half turn", 1.5, math.Pi, 0, -1.5, 0},
+		{"across the wrap", 1, -3, 3, 1, 2*math.Pi - 3},
+		{"two turns in", 1, 0.25, 4*math.Pi + 0.2, 1, 4*math.Pi + 0.25},
+		{"two turns in and reversed", 1, math.Pi, 4*math.Pi + 0.1, -1, 4 * math.Pi},
+		{"minus one turn and reversed", 1, 0.3, -3 * math.Pi, -1, 0.3 - 3*math.Pi},
+		{"still", 0, 2, 1.25, 0, 1.25},
+	}
+	for _, test := range tests {
+		t.Run(test.name, func(t *testing.T) {
+			speeds, angles, current := []float64{test.speed}, []float64{test.angle}, []float64{test.current}
+			OptimizeModuleStates(speeds, angles, current)
+			if speeds[0] != test.wantSpeed || math.Abs(angles[0]-test.wantAngle) > 1e-12 {
+				t.Errorf("got %g m/s at %g rad, want %g m/s at %g rad", speeds[0], angles[0], test.wantSpeed, test.wantAngle)
+			}
+			if math.Abs(angles[0]-current[0]) > math.Pi/2+1e-12 {
+				t.Errorf("turns %g rad, more than a quarter turn", angles[0]-current[0])
+			}
+		})
+	}
+}
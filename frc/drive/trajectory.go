@@ -0,0 +1,180 @@
+package drive
+
+import (
+	"encoding/json"
+	"io"
+	"math"
+)
+
+// Where the robot should be at Time seconds into a trajectory, and how it should be moving
+type TrajectoryState struct {
+	Time         float64
+	Pose         Pose
+	Velocity     float64 // Meters per second
+	Acceleration float64
+	Curvature    float64 // Radians per meter, positive turning counter clockwise
+}
+
+// A path with its timing worked out ahead of time, states in order of time from zero
+type Trajectory struct {
+	States []TrajectoryState
+}
+
+func (trajectory *Trajectory) Duration() float64 {
+	if len(trajectory.States) == 0 {
+		return 0
+	}
+	return trajectory.States[len(trajectory.States)-1].Time
+}
+
+// Index of the last state at or before time by binary search, clamped to the states there are
+func (trajectory *Trajectory) index(time float64) int {
+	states := trajectory.States
+	low, high := 0, len(states)
+	for low < high {
+		middle := (low + high) / 2
+		if states[middle].Time <= time {
+			low = middle + 1
+		} else {
+			high = middle
+		}
+	}
+	if low == 0 {
+		return 0
+	}
+	return low - 1
+}
+
+// The state at time, between the two states either side of it. Before the start it is the first state and after
+// the end the last
+func (trajectory *Trajectory) Sample(time float64) TrajectoryState {
+	if len(trajectory.States) == 0 {
+		return TrajectoryState{}
+	}
+	i := trajectory.index(time)
+	if i+1 >= len(trajectory.States) || time <= trajectory.States[i].Time {
+		return trajectory.States[i]
+	}
+	before, after := &trajectory.States[i], &trajectory.States[i+1]
+	t := (time - before.Time) / (after.Time - before.Time)
+	return TrajectoryState{
+		Time:         time,
+		Pose:         before.Pose.Interpolate(after.Pose, t),
+		Velocity:     before.Velocity + (after.Velocity-before.Velocity)*t,
+		Acceleration: before.Acceleration,
+		Curvature:    before.Curvature + (after.Curvature-before.Curvature)*t,
+	}
+}
+
+// Limits the generator times a path by
+type TrajectoryConfig struct {
+	MaxVelocity, MaxAcceleration float64
+	MaxCentripetal               float64 // Meters per second squared sideways in turns, zero for no limit
+}
+
+// A trajectory through waypoints, driving forward, starting and ending at rest. Between waypoints the path is a
+// cubic Hermite spline leaving and arriving along each waypoint's heading, sampled every few centimeters. The speed
+// along it is as fast as the config allows, found with a pass forward for acceleration and one back for braking
+func GenerateTrajectory(waypoints []Pose, config TrajectoryConfig) *Trajectory {
+	const samplesPerMeter = 50
+	var states []TrajectoryState
+	for segment := 0; segment+1 < len(waypoints); segment++ {
+		start, end := waypoints[segment], waypoints[segment+1]
+		chord := math.Hypot(end.X-start.X, end.Y-start.Y)
+		// Tangents as long as the chord give gentle curves without loops
+		startSin, startCos := math.Sincos(start.Heading)
+		endSin, endCos := math.Sincos(end.Heading)
+		tx0, ty0, tx1, ty1 := chord*startCos, chord*startSin, chord*endCos, chord*endSin
+		samples := int(math.Ceil(chord*samplesPerMeter)) + 1
+		first := 1
+		if segment == 0 {
+			first = 0
+		}
+		for j := first; j <= samples; j++ {
+			s := float64(j) / float64(samples)
+			s2, s3 := s*s, s*s*s
+			h00, h10, h01, h11 := 2*s3-3*s2+1, s3-2*s2+s, -2*s3+3*s2, s3-s2
+			d00, d10, d01, d11 := 6*s2-6*s, 3*s2-4*s+1, -6*s2+6*s, 3*s2-2*s
+			e00, e10, e01, e11 := 12*s-6, 6*s-4, -12*s+6, 6*s-2
+			x := h00*start.X + h10*tx0 + h01*end.X + h11*tx1
+			y := h00*start.Y + h10*ty0 + h01*end.Y + h11*ty1
+			dx := d00*start.X + d10*tx0 + d01*end.X + d11*tx1
+			dy := d00*start.Y + d10*ty0 + d01*end.Y + d11*ty1
+			ddx := e00*start.X + e10*tx0 + e01*end.X + e11*tx1
+			ddy := e00*start.Y + e10*ty0 + e01*end.Y + e11*ty1
+			speed := math.Hypot(dx, dy)
+			curvature := 0.0
+			if speed > 0 {
+				curvature = (dx*ddy - dy*ddx) / (speed * speed * speed)
+			}
+			states = append(states, TrajectoryState{Pose: Pose{x, y, math.Atan2(dy, dx)}, Curvature: curvature})
+		}
+	}
+	if len(states) == 0 {
+		return &Trajectory{}
+	}
+	// Keep headings continuous, so interpolating between states never turns the long way
+	for i := 1; i < len(states); i++ {
+		states[i].Pose.Heading = states[i-1].Pose.Heading +
+			AngleDifference(states[i].Pose.Heading, states[i-1].Pose.Heading)
+	}
+
+	distances := make([]float64, len(states))
+	for i := 1; i < len(states); i++ {
+		a, b := states[i-1].Pose, states[i].Pose
+		distances[i] = math.Hypot(b.X-a.X, b.Y-a.Y)
+	}
+	for i := range states {
+		limit := config.MaxVelocity
+		if config.MaxCentripetal > 0 && states[i].Curvature != 0 {
+			limit = math.Min(limit, math.Sqrt(config.MaxCentripetal/math.Abs(states[i].Curvature)))
+		}
+		states[i].Velocity = limit
+	}
+	states[0].Velocity, states[len(states)-1].Velocity = 0, 0
+	for i := 1; i < len(states); i++ {
+		reachable := math.Sqrt(states[i-1].Velocity*states[i-1].Velocity + 2*config.MaxAcceleration*distances[i])
+		states[i].Velocity = math.Min(states[i].Velocity, reachable)
+	}
+	for i := len(states) - 2; i >= 0; i-- {
+		stoppable := math.Sqrt(states[i+1].Velocity*states[i+1].Velocity + 2*config.MaxAcceleration*distances[i+1])
+		states[i].Velocity = math.Min(states[i].Velocity, stoppable)
+	}
+	for i := 1; i < len(states); i++ {
+		previous, state := &states[i-1], &states[i]
+		dt := 0.0
+		if average := (previous.Velocity + state.Velocity) / 2; average > 0 {
+			dt = distances[i] / average
+		}
+		state.Time = previous.Time + dt
+		if dt > 0 {
+			previous.Acceleration = (state.Velocity - previous.Velocity) / dt
+		}
+	}
+	return &Trajectory{States: states}
+}
+
+// Reads a trajectory in the JSON that WPILib's PathWeaver writes
+func ReadPathWeaverJSON(r io.Reader) (*Trajectory, error) {
+	var states []struct {
+		Time, Velocity, Acceleration, Curvature float64
+		Pose                                    struct {
+			Translation struct{ X, Y float64 }
+			Rotation    struct{ Radians float64 }
+		}
+	}
+	if err := json.NewDecoder(r).Decode(&states); err != nil {
+		return nil, err
+	}
+	trajectory := &Trajectory{States: make([]TrajectoryState, len(states))}
+	for i, state := range states {
+		trajectory.States[i] = TrajectoryState{
+			Time:         state.Time,
+			Pose:         Pose{state.Pose.Translation.X, state.Pose.Translation.Y, state.Pose.Rotation.Radians},
+			Velocity:     state.Velocity,
+			Acceleration: state.Acceleration,
+			Curvature:    state.Curvature,
+		}
+	}
+	return trajectory, nil
+}
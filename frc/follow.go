@@ -0,0 +1,59 @@
+package frc
+
+import (
+	"go-frc/frc/drive"
+	"go-frc/frc/phoenix"
+	"sync"
+)
+
+type VelocityGains struct {
+	KP, KF float64
+}
+
+var (
+	// Autonomous follows this from its first pose when it is set, instead of driving AutoGains.Distance forward
+	AutoTrajectory *drive.Trajectory
+	AutoController drive.PathController = &drive.Ramsete{B: 2, Zeta: 0.7}
+	FollowRate                          = 200.0 // Times a second the follower runs, on a task of its own
+	// The drive Talons' own velocity loops in native units, kF is 1023 over the ticks per 100 ms at full output
+	DriveVelocityGains = VelocityGains{KP: 0.3, KF: 0.3}
+
+	followTask  *Task
+	followBatch *phoenix.TalonBatch
+	// The follower updates the pose estimator from its own thread, everything else using it takes this too
+	poseLock sync.Mutex
+)
+
+// Drives along trajectory from now until stopFollowing. The follower updates the pose, asks the controller where to
+// go and sets the drive Talons' velocities, FollowRate times a second independently of the loop
+func startFollowing(trajectory *drive.Trajectory, controller drive.PathController) {
+	if followBatch == nil {
+		left.ConfigPID(DriveVelocityGains.KP, 0, 0, DriveVelocityGains.KF)
+		right.ConfigPID(DriveVelocityGains.KP, 0, 0, DriveVelocityGains.KF)
+		followBatch = phoenix.NewTalonBatch(left, right)
+	}
+	start := getFPGATime()
+	followTask = StartTask("path follower", 1/FollowRate, func(float64) {
+		leftDistance, rightDistance, gyro := readDrive()
+		poseLock.Lock()
+		now := getFPGATime()
+		pose := poseEstimator.Update(now, leftDistance, rightDistance, gyro)
+		poseLock.Unlock()
+		velocity, omega := controller.Calculate(trajectory, now-start, pose)
+		leftSpeed, rightSpeed := drive.DifferentialWheelSpeeds(velocity, omega, DriveTrackWidth)
+		// Talons count velocity per 100 ms, and the right side is mirrored
+		followBatch.Set(0, phoenix.Velocity, leftSpeed*DriveTicksPerMeter/10)
+		followBatch.Set(1, phoenix.Velocity, -rightSpeed*DriveTicksPerMeter/10)
+		followBatch.Send()
+	})
+}
+
+// Waits for a run of the follower that is under way, then lets the drive go
+func stopFollowing() {
+	if followTask != nil {
+		followTask.Stop()
+		followTask = nil
+		left.Set(0)
+		right.Set(0)
+	}
+}
@@ -0,0 +1,116 @@
+package frc
+
+import (
+	"fmt"
+	"reflect"
+	"runtime"
+	"runtime/debug"
+)
+
+// Garbage collector settings applied by Start. Collections are moved into the time left over after a tick,
+// so the collector is not running through the middle of one
+type GCConfig struct {
+	Percent     int   // For debug.SetGCPercent, -1 leaves collecting to the slack time and the memory limit
+	MemoryLimit int64 // Bytes, applied with debug.SetMemoryLimit on Go 1.19 and newer, zero keeps the default
+	// Collect after a tick once this many bytes were allocated since the last collection, zero never does
+	SlackHeap uint64
+	SlackTime float64 // Seconds that must be left before the next tick to start a collection
+	// Print every periodic function that keeps allocating. One function is checked per tick, in turn, at the cost of
+	// a second stop of the world in that tick
+	CheckAllocations bool
+}
+
+// Checks in a row a function has to allocate in before it is reported. Allocation counts are for the whole program,
+// so this keeps one unlucky overlap with another goroutine from being blamed on the loop
+const allocationStreak = 5
+
+var (
+	GCTuning = GCConfig{Percent: 400, SlackHeap: 4 << 20, SlackTime: 0.01}
+
+	collectedAt    uint64 // Bytes allocated as of the last collection, by the slack or the runtime
+	collections    uint32
+	allocations    = make(map[string]*allocationStats)
+	allocationTurn int
+	// ReadMemStats stops the world for a few microseconds, but unlike runtime/metrics it counts every allocation.
+	// A tick reads it once, the allocation check's second read stands in for the slack's
+	memStats     runtime.MemStats
+	memStatsRead bool
+)
+
+type allocationStats struct {
+	streak  int
+	flagged bool
+}
+
+func applyGCConfig(config GCConfig) {
+	debug.SetGCPercent(config.Percent)
+	setMemoryLimit(config.MemoryLimit)
+}
+
+func functionName(function func()) string {
+	return runtime.FuncForPC(reflect.ValueOf(function).Pointer()).Name()
+}
+
+// Bytes and objects allocated since the program started
+func readAllocations() (uint64, uint64) {
+	runtime.ReadMemStats(&memStats)
+	memStatsRead = true
+	return memStats.TotalAlloc, memStats.Mallocs
+}
+
+// Runs the periodic function in the given slot of the tick, timed by its span, and when it is that slot's turn to be
+// checked reports it once it has allocated in allocationStreak checks in a row
+func checkAllocations(slot int, span *Span, function func()) {
+	if !GCTuning.CheckAllocations || slot != allocationTurn {
+		span.Begin()
+		function()
+		span.End()
+		return
+	}
+	bytesBefore, objectsBefore := readAllocations()
+	span.Begin()
+	function()
+	span.End()
+	bytesAfter, objectsAfter := readAllocations()
+	stats := allocations[span.Name]
+	if stats == nil {
+		stats = &allocationStats{}
+		allocations[span.Name] = stats
+	}
+	if objectsAfter == objectsBefore {
+		stats.streak = 0
+		return
+	}
+	stats.streak++
+	if stats.streak == allocationStreak && !stats.flagged {
+		stats.flagged = true
+		fmt.Printf("%s allocates, %d bytes in %d objects on its last call\n", span.Name, bytesAfter-bytesBefore,
+			objectsAfter-objectsBefore)
+	}
+}
+
+// Moves the check on to the next slot, slots is how many periodic functions the tick ran
+func nextAllocationTurn(slots int) {
+	allocationTurn = (allocationTurn + 1) % slots
+}
+
+// Collects now if enough was allocated since the last collection and the next tick is far enough away. A collection
+// is noticed by the tick after it, so the bytes allocated in between count towards the next one
+func collectInSlack(deadline float64) {
+	read := memStatsRead
+	memStatsRead = false
+	if GCTuning.SlackHeap == 0 {
+		return
+	}
+	if !read {
+		runtime.ReadMemStats(&memStats)
+	}
+	if memStats.NumGC != collections {
+		collections = memStats.NumGC
+		collectedAt = memStats.TotalAlloc
+	}
+	if memStats.TotalAlloc-collectedAt < GCTuning.SlackHeap || deadline-getFPGATime() < GCTuning.SlackTime {
+		return
+	}
+	runtime.GC()
+}
@@ -0,0 +1,12 @@
+//go:build go1.19
+// +build go1.19
+
+package frc
+
+import "runtime/debug"
+
+func setMemoryLimit(limit int64) {
+	if limit > 0 {
+		debug.SetMemoryLimit(limit)
+	}
+}
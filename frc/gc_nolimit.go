@@ -0,0 +1,12 @@
+//go:build !go1.19
+// +build !go1.19
+
+package frc
+
+import "fmt"
+
+func setMemoryLimit(limit int64) {
+	if limit > 0 {
+		fmt.Println("A memory limit needs Go 1.19, it is ignored")
+	}
+}
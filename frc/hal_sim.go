@@ -0,0 +1,9 @@
+//go:build sim
+// +build sim
+
+package frc
+
+import (
+	// Provides the HAL symbols in place of the roboRIO libraries
+	_ "go-frc/frc/halsim"
+)
@@ -0,0 +1,859 @@
+//go:build sim
+// +build sim
+
+// In-process stand-in for the roboRIO HAL so the robot loop can run on a desktop.
+// Only the parts of the HAL used by the Go code are implemented, everything else is left undefined so that
+// using something new fails at link time rather than silently doing nothing
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hal.h"
+#include "hal/CAN.h"
+#include "hal/Errors.h"
+#include "hal/SimDevice.h"
+#include "halsim.h"
+
+#define MAX_NOTIFIERS 32
+#define MAX_PWMS 20
+#define MAX_MODULES 64
+#define MAX_SERIAL_PORTS 4
+#define MAX_I2C_DEVICES 16
+#define MAX_I2C_DATA 32
+#define MAX_SIM_DEVICES 64
+#define MAX_SIM_VALUES 512
+#define MAX_SIM_NAME 64
+#define MAX_CAN_IDS 256
+#define MAX_CAN_SESSIONS 32
+#define CAN_QUEUE_SIZE 256
+
+#define NO_ALARM UINT64_MAX
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t notifierCondition, stepCondition;
+static pthread_once_t initOnce = PTHREAD_ONCE_INIT;
+static uint64_t startTime;
+
+// With the stepped clock, time only moves when HALSIM_Step jumps it to the next notifier alarm
+static int stepped;
+static uint64_t virtualTime;
+
+static uint64_t monotonicMicroseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000u + (uint64_t) now.tv_nsec / 1000u;
+}
+
+static void initialize(void) {
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&notifierCondition, &attributes);
+    pthread_cond_init(&stepCondition, &attributes);
+    pthread_condattr_destroy(&attributes);
+    startTime = monotonicMicroseconds();
+}
+
+static uint64_t fpgaTime(void) {
+    return stepped ? virtualTime : monotonicMicroseconds() - startTime;
+}
+
+/* Base */
+
+static HAL_ControlWord controlWord;
+
+HAL_Bool HAL_Initialize(int32_t timeout, int32_t mode) {
+    pthread_once(&initOnce, initialize);
+    // HALSIM_MODE lets the loop be run straight from the command line
+    const char* simMode = getenv("HALSIM_MODE");
+    if (simMode) {
+        int enabled = strcmp(simMode, "disabled") != 0;
+        HALSIM_SetControlWord(enabled, strcmp(simMode, "autonomous") == 0, strcmp(simMode, "test") == 0, 0, 0, 1);
+    }
+    return 1;
+}
+
+uint64_t HAL_GetFPGATime(int32_t* status) {
+    *status = 0;
+    pthread_mutex_lock(&mutex);
+    uint64_t time = fpgaTime();
+    pthread_mutex_unlock(&mutex);
+    return time;
+}
+
+HAL_PortHandle HAL_GetPort(int32_t channel) {
+    return HAL_GetPortWithModule(0, channel);
+}
+
+HAL_PortHandle HAL_GetPortWithModule(int32_t module, int32_t channel) {
+    return (module << 8 | channel) + 1;
+}
+
+static int32_t portChannel(HAL_PortHandle port) {
+    return (port - 1) & 0xFF;
+}
+
+static int32_t portModule(HAL_PortHandle port) {
+    return (port - 1) >> 8;
+}
+
+/* Driver station */
+
+static HAL_JoystickAxes joystickAxes[HAL_kMaxJoysticks];
+
+void HALSIM_SetControlWord(int32_t enabled, int32_t autonomous, int32_t test, int32_t eStop, int32_t fmsAttached, int32_t dsAttached) {
+    pthread_mutex_lock(&mutex);
+    memset(&controlWord, 0, sizeof(controlWord));
+    controlWord.enabled = enabled != 0;
+    controlWord.autonomous = autonomous != 0;
+    controlWord.test = test != 0;
+    controlWord.eStop = eStop != 0;
+    controlWord.fmsAttached = fmsAttached != 0;
+    controlWord.dsAttached = dsAttached != 0;
+    pthread_mutex_unlock(&mutex);
+}
+
+int32_t HAL_GetControlWord(HAL_ControlWord* word) {
+    pthread_mutex_lock(&mutex);
+    *word = controlWord;
+    pthread_mutex_unlock(&mutex);
+    return 0;
+}
+
+void HALSIM_SetJoystickAxes(int32_t joystick, const float* axes, int32_t count) {
+    if (joystick < 0 || joystick >= HAL_kMaxJoysticks || count > HAL_kMaxJoystickAxes) return;
+    pthread_mutex_lock(&mutex);
+    joystickAxes[joystick].count = count;
+    memcpy(joystickAxes[joystick].axes, axes, count * sizeof(float));
+    pthread_mutex_unlock(&mutex);
+}
+
+int32_t HAL_GetJoystickAxes(int32_t joystick, HAL_JoystickAxes* axes) {
+    if (joystick < 0 || joystick >= HAL_kMaxJoysticks) return PARAMETER_OUT_OF_RANGE;
+    pthread_mutex_lock(&mutex);
+    *axes = joystickAxes[joystick];
+    pthread_mutex_unlock(&mutex);
+    return 0;
+}
+
+void HAL_ObserveUserProgramStarting(void) {}
+void HAL_ObserveUserProgramDisabled(void) {}
+void HAL_ObserveUserProgramAutonomous(void) {}
+void HAL_ObserveUserProgramTeleop(void) {}
+void HAL_ObserveUserProgramTest(void) {}
+
+/* Notifier */
+
+static struct {
+    int used, stopped;
+    uint64_t alarm;
+} notifiers[MAX_NOTIFIERS];
+static int notifierWaiters, notifiersShutDown;
+static uint64_t alarmsFired;
+
+HAL_NotifierHandle HAL_InitializeNotifier(int32_t* status) {
+    pthread_once(&initOnce, initialize);
+    pthread_mutex_lock(&mutex);
+    for (int i = 0; i < MAX_NOTIFIERS; i++) {
+        if (!notifiers[i].used) {
+            notifiers[i].used = 1;
+            notifiers[i].stopped = 0;
+            notifiers[i].alarm = NO_ALARM;
+            pthread_mutex_unlock(&mutex);
+            *status = 0;
+            return i + 1;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    *status = NO_AVAILABLE_RESOURCES;
+    return HAL_kInvalidHandle;
+}
+
+#define NOTIFIER(handle) (notifiers[(handle) - 1])
+
+static int32_t checkNotifier(HAL_NotifierHandle handle) {
+    return handle > 0 && handle <= MAX_NOTIFIERS && NOTIFIER(handle).used ? 0 : HAL_HANDLE_ERROR;
+}
+
+void HAL_StopNotifier(HAL_NotifierHandle handle, int32_t* status) {
+    if ((*status = checkNotifier(handle))) return;
+    pthread_mutex_lock(&mutex);
+    NOTIFIER(handle).stopped = 1;
+    pthread_cond_broadcast(&notifierCondition);
+    pthread_cond_broadcast(&stepCondition);
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_CleanNotifier(HAL_NotifierHandle handle, int32_t* status) {
+    if ((*status = checkNotifier(handle))) return;
+    pthread_mutex_lock(&mutex);
+    NOTIFIER(handle).used = 0;
+    NOTIFIER(handle).stopped = 1;
+    pthread_cond_broadcast(&notifierCondition);
+    pthread_cond_broadcast(&stepCondition);
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_UpdateNotifierAlarm(HAL_NotifierHandle handle, uint64_t triggerTime, int32_t* status) {
+    if ((*status = checkNotifier(handle))) return;
+    pthread_mutex_lock(&mutex);
+    NOTIFIER(handle).alarm = triggerTime;
+    pthread_cond_broadcast(&notifierCondition);
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_CancelNotifierAlarm(HAL_NotifierHandle handle, int32_t* status) {
+    HAL_UpdateNotifierAlarm(handle, NO_ALARM, status);
+}
+
+uint64_t HAL_WaitForNotifierAlarm(HAL_NotifierHandle handle, int32_t* status) {
+    if ((*status = checkNotifier(handle))) return 0;
+    pthread_mutex_lock(&mutex);
+    for (;;) {
+        if (NOTIFIER(handle).stopped) {
+            pthread_mutex_unlock(&mutex);
+            return 0;
+        }
+        uint64_t alarm = NOTIFIER(handle).alarm, now = fpgaTime();
+        if (alarm != NO_ALARM && now >= alarm) {
+            NOTIFIER(handle).alarm = NO_ALARM; // Fires once per update like the real notifier
+            alarmsFired++;
+            pthread_cond_broadcast(&stepCondition);
+            pthread_mutex_unlock(&mutex);
+            return now;
+        }
+        if (stepped) {
+            // Parked until the stepper moves time, let it know this thread is done with the tick
+            notifierWaiters++;
+            pthread_cond_broadcast(&stepCondition);
+            pthread_cond_wait(&notifierCondition, &mutex);
+            notifierWaiters--;
+        } else if (alarm == NO_ALARM) {
+            pthread_cond_wait(&notifierCondition, &mutex);
+        } else {
+            uint64_t wake = startTime + alarm;
+            struct timespec deadline = {(time_t) (wake / 1000000u), (long) (wake % 1000000u) * 1000};
+            pthread_cond_timedwait(&notifierCondition, &mutex, &deadline);
+        }
+    }
+}
+
+static int activeNotifiers(void) {
+    int active = 0;
+    for (int i = 0; i < MAX_NOTIFIERS; i++) active += notifiers[i].used && !notifiers[i].stopped;
+    return active;
+}
+
+// Waits until every notifier thread is parked in HAL_WaitForNotifierAlarm, returns false if they were shut down
+static int waitForNotifiersIdle(void) {
+    while (!notifiersShutDown && (activeNotifiers() == 0 || notifierWaiters < activeNotifiers())) {
+        pthread_cond_wait(&stepCondition, &mutex);
+    }
+    return !notifiersShutDown;
+}
+
+void HALSIM_SetSteppedClock(int32_t enabled) {
+    pthread_once(&initOnce, initialize);
+    pthread_mutex_lock(&mutex);
+    if (enabled && !stepped) {
+        virtualTime = fpgaTime(); // Continue from the real clock so time never goes backwards
+    } else if (!enabled && stepped) {
+        startTime = monotonicMicroseconds() - virtualTime;
+    }
+    stepped = enabled != 0;
+    pthread_cond_broadcast(&notifierCondition);
+    pthread_mutex_unlock(&mutex);
+}
+
+// Jumps time to the earliest alarm if it is no later than limit and waits for it to fire, false if there is none
+static int fireNextAlarm(uint64_t limit) {
+    if (!waitForNotifiersIdle()) return 0;
+    uint64_t next = NO_ALARM;
+    for (int n = 0; n < MAX_NOTIFIERS; n++) {
+        if (notifiers[n].used && !notifiers[n].stopped && notifiers[n].alarm < next) next = notifiers[n].alarm;
+    }
+    if (next == NO_ALARM || next > limit) return 0;
+    if (next > virtualTime) virtualTime = next;
+    uint64_t fired = alarmsFired;
+    pthread_cond_broadcast(&notifierCondition);
+    while (!notifiersShutDown && alarmsFired == fired) pthread_cond_wait(&stepCondition, &mutex);
+    return 1;
+}
+
+uint64_t HALSIM_Step(int32_t alarms) {
+    pthread_mutex_lock(&mutex);
+    for (int32_t i = 0; i < alarms && stepped && fireNextAlarm(NO_ALARM - 1); i++) {}
+    // Return only once the last tick has been fully processed
+    if (stepped) waitForNotifiersIdle();
+    uint64_t time = fpgaTime();
+    pthread_mutex_unlock(&mutex);
+    return time;
+}
+
+uint64_t HALSIM_StepTime(uint64_t microseconds) {
+    pthread_mutex_lock(&mutex);
+    if (stepped) {
+        uint64_t end = virtualTime + microseconds;
+        while (fireNextAlarm(end)) {}
+        if (!notifiersShutDown && virtualTime < end) virtualTime = end;
+        waitForNotifiersIdle();
+    }
+    uint64_t time = fpgaTime();
+    pthread_mutex_unlock(&mutex);
+    return time;
+}
+
+void HALSIM_ShutdownNotifiers(void) {
+    pthread_mutex_lock(&mutex);
+    for (int i = 0; i < MAX_NOTIFIERS; i++) notifiers[i].stopped = 1;
+    notifiersShutDown = 1;
+    pthread_cond_broadcast(&notifierCondition);
+    pthread_cond_broadcast(&stepCondition);
+    pthread_mutex_unlock(&mutex);
+}
+
+/* Power */
+
+static double pdpVoltage = 12.5, pdpCurrents[16], pdpEnergy;
+static uint64_t pdpLastUpdate;
+
+void HALSIM_SetPDP(double voltage, const double* channelCurrents, int32_t count) {
+    pthread_mutex_lock(&mutex);
+    uint64_t now = fpgaTime();
+    double total = 0;
+    for (int i = 0; i < 16; i++) total += pdpCurrents[i];
+    if (pdpLastUpdate) pdpEnergy += pdpVoltage * total * (double) (now - pdpLastUpdate) * 1e-6;
+    pdpLastUpdate = now;
+    pdpVoltage = voltage;
+    for (int i = 0; i < 16; i++) pdpCurrents[i] = i < count ? channelCurrents[i] : 0;
+    pthread_mutex_unlock(&mutex);
+}
+
+HAL_PDPHandle HAL_InitializePDP(int32_t module, int32_t* status) {
+    *status = 0;
+    return module + 1;
+}
+
+void HAL_CleanPDP(HAL_PDPHandle handle) {}
+
+double HAL_GetPDPVoltage(HAL_PDPHandle handle, int32_t* status) {
+    *status = 0;
+    pthread_mutex_lock(&mutex);
+    double voltage = pdpVoltage;
+    pthread_mutex_unlock(&mutex);
+    return voltage;
+}
+
+double HAL_GetPDPChannelCurrent(HAL_PDPHandle handle, int32_t channel, int32_t* status) {
+    if (channel < 0 || channel >= 16) {
+        *status = PARAMETER_OUT_OF_RANGE;
+        return 0;
+    }
+    *status = 0;
+    pthread_mutex_lock(&mutex);
+    double current = pdpCurrents[channel];
+    pthread_mutex_unlock(&mutex);
+    return current;
+}
+
+double HAL_GetPDPTotalCurrent(HAL_PDPHandle handle, int32_t* status) {
+    *status = 0;
+    double total = 0;
+    pthread_mutex_lock(&mutex);
+    for (int i = 0; i < 16; i++) total += pdpCurrents[i];
+    pthread_mutex_unlock(&mutex);
+    return total;
+}
+
+double HAL_GetPDPTotalEnergy(HAL_PDPHandle handle, int32_t* status) {
+    *status = 0;
+    pthread_mutex_lock(&mutex);
+    double energy = pdpEnergy;
+    pthread_mutex_unlock(&mutex);
+    return energy;
+}
+
+HAL_Bool HAL_GetBrownedOut(int32_t* status) {
+    *status = 0;
+    pthread_mutex_lock(&mutex);
+    HAL_Bool brownedOut = pdpVoltage < 6.8;
+    pthread_mutex_unlock(&mutex);
+    return brownedOut;
+}
+
+/* Pneumatics */
+
+static int32_t solenoids[MAX_MODULES];
+static HAL_Bool closedLoop[MAX_MODULES];
+
+int32_t HALSIM_GetSolenoids(int32_t module) {
+    pthread_mutex_lock(&mutex);
+    int32_t state = module >= 0 && module < MAX_MODULES ? solenoids[module] : 0;
+    pthread_mutex_unlock(&mutex);
+    return state;
+}
+
+void HAL_SetAllSolenoids(int32_t module, int32_t state, int32_t* status) {
+    if (module < 0 || module >= MAX_MODULES) {
+        *status = PARAMETER_OUT_OF_RANGE;
+        return;
+    }
+    *status = 0;
+    pthread_mutex_lock(&mutex);
+    solenoids[module] = state;
+    pthread_mutex_unlock(&mutex);
+}
+
+int32_t HAL_GetAllSolenoids(int32_t module, int32_t* status) {
+    *status = 0;
+    return HALSIM_GetSolenoids(module);
+}
+
+HAL_SolenoidHandle HAL_InitializeSolenoidPort(HAL_PortHandle port, int32_t* status) {
+    *status = 0;
+    return port;
+}
+
+void HAL_SetOneShotDuration(HAL_SolenoidHandle handle, int32_t durationMs, int32_t* status) {
+    *status = 0;
+}
+
+void HAL_FireOneShot(HAL_SolenoidHandle handle, int32_t* status) {
+    *status = 0;
+}
+
+HAL_CompressorHandle HAL_InitializeCompressor(int32_t module, int32_t* status) {
+    if (module < 0 || module >= MAX_MODULES) {
+        *status = PARAMETER_OUT_OF_RANGE;
+        return HAL_kInvalidHandle;
+    }
+    *status = 0;
+    closedLoop[module] = 1;
+    return module + 1;
+}
+
+void HAL_SetCompressorClosedLoopControl(HAL_CompressorHandle handle, HAL_Bool value, int32_t* status) {
+    *status = 0;
+    closedLoop[handle - 1] = value;
+}
+
+HAL_Bool HAL_GetCompressorClosedLoopControl(HAL_CompressorHandle handle, int32_t* status) {
+    *status = 0;
+    return closedLoop[handle - 1];
+}
+
+HAL_Bool HAL_GetCompressor(HAL_CompressorHandle handle, int32_t* status) {
+    *status = 0;
+    return 0;
+}
+
+HAL_Bool HAL_GetCompressorPressureSwitch(HAL_CompressorHandle handle, int32_t* status) {
+    *status = 0;
+    return 1;
+}
+
+double HAL_GetCompressorCurrent(HAL_CompressorHandle handle, int32_t* status) {
+    *status = 0;
+    return 0;
+}
+
+/* PWM */
+
+static double pwmSpeeds[MAX_PWMS];
+
+double HALSIM_GetPWMSpeed(int32_t channel) {
+    pthread_mutex_lock(&mutex);
+    double speed = channel >= 0 && channel < MAX_PWMS ? pwmSpeeds[channel] : 0;
+    pthread_mutex_unlock(&mutex);
+    return speed;
+}
+
+HAL_DigitalHandle HAL_InitializePWMPort(HAL_PortHandle port, int32_t* status) {
+    if (portChannel(port) >= MAX_PWMS) {
+        *status = PARAMETER_OUT_OF_RANGE;
+        return HAL_kInvalidHandle;
+    }
+    *status = 0;
+    return port;
+}
+
+void HAL_SetPWMConfig(HAL_DigitalHandle handle, double maxPwm, double deadbandMaxPwm, double centerPwm,
+                      double deadbandMinPwm, double minPwm, int32_t* status) {
+    *status = 0;
+}
+
+void HAL_SetPWMEliminateDeadband(HAL_DigitalHandle handle, HAL_Bool eliminateDeadband, int32_t* status) {
+    *status = 0;
+}
+
+void HAL_SetPWMPeriodScale(HAL_DigitalHandle handle, int32_t squelchMask, int32_t* status) {
+    *status = 0;
+}
+
+void HAL_SetPWMSpeed(HAL_DigitalHandle handle, double speed, int32_t* status) {
+    *status = 0;
+    pthread_mutex_lock(&mutex);
+    pwmSpeeds[portChannel(handle)] = speed < -1 ? -1 : speed > 1 ? 1 : speed;
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_SetPWMDisabled(HAL_DigitalHandle handle, int32_t* status) {
+    HAL_SetPWMSpeed(handle, 0, status);
+}
+
+void HAL_LatchPWMZero(HAL_DigitalHandle handle, int32_t* status) {
+    HAL_SetPWMSpeed(handle, 0, status);
+}
+
+/* Serial, each port is a pseudo terminal so the other end can be written by a test like a co-processor would */
+
+static int serialMasters[MAX_SERIAL_PORTS] = {-1, -1, -1, -1}, serialSlaves[MAX_SERIAL_PORTS] = {-1, -1, -1, -1};
+
+int HALSIM_GetSerialMasterFD(int32_t port) {
+    return port >= 0 && port < MAX_SERIAL_PORTS ? serialMasters[port] : -1;
+}
+
+HAL_SerialPortHandle HAL_InitializeSerialPort(HAL_SerialPort port, int32_t* status) {
+    if (port < 0 || port >= MAX_SERIAL_PORTS) {
+        *status = PARAMETER_OUT_OF_RANGE;
+        return HAL_kInvalidHandle;
+    }
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) || unlockpt(master)) {
+        *status = RESOURCE_OUT_OF_RANGE;
+        return HAL_kInvalidHandle;
+    }
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    struct termios attributes;
+    if (slave < 0 || tcgetattr(slave, &attributes)) {
+        *status = RESOURCE_OUT_OF_RANGE;
+        return HAL_kInvalidHandle;
+    }
+    cfmakeraw(&attributes);
+    tcsetattr(slave, TCSANOW, &attributes);
+    serialMasters[port] = master;
+    serialSlaves[port] = slave;
+    *status = 0;
+    return port + 1;
+}
+
+void HAL_SetSerialBaudRate(HAL_SerialPortHandle handle, int32_t baud, int32_t* status) {
+    *status = 0;
+}
+
+int HAL_GetSerialFD(HAL_SerialPortHandle handle, int32_t* status) {
+    *status = 0;
+    return serialSlaves[handle - 1];
+}
+
+void HAL_CloseSerial(HAL_SerialPortHandle handle, int32_t* status) {
+    *status = 0;
+    close(serialSlaves[handle - 1]);
+    close(serialMasters[handle - 1]);
+    serialMasters[handle - 1] = serialSlaves[handle - 1] = -1;
+}
+
+/* I2C, devices answer every transaction with whatever data was last set for them */
+
+static struct {
+    int32_t port, address, size;
+    uint8_t data[MAX_I2C_DATA];
+} i2cDevices[MAX_I2C_DEVICES];
+static int i2cDeviceCount;
+
+void HALSIM_SetI2CData(int32_t port, int32_t address, const uint8_t* data, int32_t size) {
+    if (size > MAX_I2C_DATA) size = MAX_I2C_DATA;
+    pthread_mutex_lock(&mutex);
+    int i = 0;
+    while (i < i2cDeviceCount && (i2cDevices[i].port != port || i2cDevices[i].address != address)) i++;
+    if (i < MAX_I2C_DEVICES) {
+        if (i == i2cDeviceCount) i2cDeviceCount++;
+        i2cDevices[i].port = port;
+        i2cDevices[i].address = address;
+        i2cDevices[i].size = size;
+        memcpy(i2cDevices[i].data, data, size);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_InitializeI2C(HAL_I2CPort port, int32_t* status) {
+    *status = 0;
+}
+
+int32_t HAL_TransactionI2C(HAL_I2CPort port, int32_t address, const uint8_t* dataToSend, int32_t sendSize,
+                           uint8_t* dataReceived, int32_t receiveSize) {
+    int32_t result = -1; // No device acknowledged
+    pthread_mutex_lock(&mutex);
+    for (int i = 0; i < i2cDeviceCount; i++) {
+        if (i2cDevices[i].port == port && i2cDevices[i].address == address) {
+            memset(dataReceived, 0, receiveSize);
+            memcpy(dataReceived, i2cDevices[i].data, receiveSize < i2cDevices[i].size ? receiveSize : i2cDevices[i].size);
+            result = 0;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return result;
+}
+
+void HAL_CloseI2C(HAL_I2CPort port) {}
+
+/* Sim devices, how simulated motor controllers and sensors expose their state to physics models */
+
+static struct {
+    int used;
+    char name[MAX_SIM_NAME];
+} simDevices[MAX_SIM_DEVICES];
+
+static struct {
+    HAL_SimDeviceHandle device;
+    char name[MAX_SIM_NAME];
+    struct HAL_Value value;
+} simValues[MAX_SIM_VALUES];
+static int simValueCount;
+
+HAL_SimDeviceHandle HAL_CreateSimDevice(const char* name) {
+    pthread_mutex_lock(&mutex);
+    for (int i = 0; i < MAX_SIM_DEVICES; i++) {
+        if (!simDevices[i].used) {
+            simDevices[i].used = 1;
+            strncpy(simDevices[i].name, name, MAX_SIM_NAME - 1);
+            pthread_mutex_unlock(&mutex);
+            return i + 1;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return HAL_kInvalidHandle;
+}
+
+void HAL_FreeSimDevice(HAL_SimDeviceHandle handle) {
+    if (handle <= 0 || handle > MAX_SIM_DEVICES) return;
+    pthread_mutex_lock(&mutex);
+    simDevices[handle - 1].used = 0;
+    for (int i = 0; i < simValueCount; i++) {
+        if (simValues[i].device == handle) simValues[i].device = HAL_kInvalidHandle;
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+HAL_SimValueHandle HAL_CreateSimValue(HAL_SimDeviceHandle device, const char* name, HAL_Bool readonly,
+                                      const struct HAL_Value* initialValue) {
+    if (device <= 0 || device > MAX_SIM_DEVICES) return HAL_kInvalidHandle;
+    pthread_mutex_lock(&mutex);
+    if (simValueCount == MAX_SIM_VALUES) {
+        pthread_mutex_unlock(&mutex);
+        return HAL_kInvalidHandle;
+    }
+    int i = simValueCount++;
+    simValues[i].device = device;
+    strncpy(simValues[i].name, name, MAX_SIM_NAME - 1);
+    simValues[i].value = *initialValue;
+    pthread_mutex_unlock(&mutex);
+    return i + 1;
+}
+
+void HAL_GetSimValue(HAL_SimValueHandle handle, struct HAL_Value* value) {
+    if (handle <= 0 || handle > simValueCount) return;
+    pthread_mutex_lock(&mutex);
+    *value = simValues[handle - 1].value;
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_SetSimValue(HAL_SimValueHandle handle, const struct HAL_Value* value) {
+    if (handle <= 0 || handle > simValueCount) return;
+    pthread_mutex_lock(&mutex);
+    simValues[handle - 1].value = *value;
+    pthread_mutex_unlock(&mutex);
+}
+
+HAL_SimValueHandle HALSIM_FindSimValue(const char* device, const char* name) {
+    HAL_SimValueHandle handle = HAL_kInvalidHandle;
+    pthread_mutex_lock(&mutex);
+    for (int i = 0; i < simValueCount && !handle; i++) {
+        HAL_SimDeviceHandle owner = simValues[i].device;
+        if (owner && !strcmp(simDevices[owner - 1].name, device) && !strcmp(simValues[i].name, name)) handle = i + 1;
+    }
+    pthread_mutex_unlock(&mutex);
+    return handle;
+}
+
+// Batched so a physics step costs one crossing for all of its values instead of one each
+void HALSIM_GetSimDoubles(const HAL_SimValueHandle* handles, double* values, int32_t count) {
+    pthread_mutex_lock(&mutex);
+    for (int32_t i = 0; i < count; i++) {
+        HAL_SimValueHandle handle = handles[i];
+        values[i] = handle > 0 && handle <= simValueCount ? simValues[handle - 1].value.data.v_double : 0;
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void HALSIM_SetSimDoubles(const HAL_SimValueHandle* handles, const double* values, int32_t count) {
+    pthread_mutex_lock(&mutex);
+    for (int32_t i = 0; i < count; i++) {
+        HAL_SimValueHandle handle = handles[i];
+        if (handle > 0 && handle <= simValueCount) {
+            simValues[handle - 1].value.type = HAL_DOUBLE;
+            simValues[handle - 1].value.data.v_double = values[i];
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+/* CAN */
+
+struct canQueue {
+    struct HAL_CANStreamMessage messages[CAN_QUEUE_SIZE];
+    uint32_t head, tail, capacity;
+};
+
+static void canPush(struct canQueue* queue, const struct HAL_CANStreamMessage* message) {
+    if (queue->head - queue->tail == queue->capacity) queue->tail++; // Drop the oldest
+    queue->messages[queue->head++ % CAN_QUEUE_SIZE] = *message;
+}
+
+static int canPop(struct canQueue* queue, struct HAL_CANStreamMessage* message) {
+    if (queue->head == queue->tail) return 0;
+    *message = queue->messages[queue->tail++ % CAN_QUEUE_SIZE];
+    return 1;
+}
+
+// Latest frame per ID for HAL_CAN_ReceiveMessage
+static struct {
+    struct HAL_CANStreamMessage message;
+    int unread;
+} canLatest[MAX_CAN_IDS];
+static int canLatestCount;
+
+static struct {
+    int used, overrun;
+    uint32_t messageID, messageIDMask;
+    struct canQueue queue;
+} canSessions[MAX_CAN_SESSIONS];
+
+static struct canQueue canSent = {.capacity = CAN_QUEUE_SIZE};
+
+static int canMatches(uint32_t id, uint32_t filter, uint32_t mask) {
+    return (id & mask) == (filter & mask);
+}
+
+void HALSIM_InjectCANFrame(uint32_t messageID, const uint8_t* data, uint8_t dataSize) {
+    struct HAL_CANStreamMessage message = {.messageID = messageID, .dataSize = dataSize > 8 ? 8 : dataSize};
+    memcpy(message.data, data, message.dataSize);
+    pthread_mutex_lock(&mutex);
+    message.timeStamp = (uint32_t) (fpgaTime() / 1000u);
+    int i = 0;
+    while (i < canLatestCount && canLatest[i].message.messageID != messageID) i++;
+    if (i < MAX_CAN_IDS) {
+        if (i == canLatestCount) canLatestCount++;
+        canLatest[i].message = message;
+        canLatest[i].unread = 1;
+    }
+    for (i = 0; i < MAX_CAN_SESSIONS; i++) {
+        if (canSessions[i].used && canMatches(messageID, canSessions[i].messageID, canSessions[i].messageIDMask)) {
+            if (canSessions[i].queue.head - canSessions[i].queue.tail == canSessions[i].queue.capacity) canSessions[i].overrun = 1;
+            canPush(&canSessions[i].queue, &message);
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+int32_t HALSIM_ReadSentCANFrame(uint32_t* messageID, uint8_t* data, uint8_t* dataSize, uint32_t* timeStamp) {
+    struct HAL_CANStreamMessage message;
+    pthread_mutex_lock(&mutex);
+    int read = canPop(&canSent, &message);
+    pthread_mutex_unlock(&mutex);
+    if (!read) return 0;
+    *messageID = message.messageID;
+    memcpy(data, message.data, message.dataSize);
+    *dataSize = message.dataSize;
+    *timeStamp = message.timeStamp;
+    return 1;
+}
+
+// Repeating sends are recorded once, there is no device on the other end that would care about the repeats
+void HAL_CAN_SendMessage(uint32_t messageID, const uint8_t* data, uint8_t dataSize, int32_t periodMs, int32_t* status) {
+    *status = 0;
+    if (periodMs == HAL_CAN_SEND_PERIOD_STOP_REPEATING) return;
+    struct HAL_CANStreamMessage message = {.messageID = messageID, .dataSize = dataSize > 8 ? 8 : dataSize};
+    memcpy(message.data, data, message.dataSize);
+    pthread_mutex_lock(&mutex);
+    message.timeStamp = (uint32_t) (fpgaTime() / 1000u);
+    canPush(&canSent, &message);
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_CAN_ReceiveMessage(uint32_t* messageID, uint32_t messageIDMask, uint8_t* data, uint8_t* dataSize,
+                            uint32_t* timeStamp, int32_t* status) {
+    *status = HAL_ERR_CANSessionMux_MessageNotFound;
+    pthread_mutex_lock(&mutex);
+    for (int i = 0; i < canLatestCount; i++) {
+        if (canLatest[i].unread && canMatches(canLatest[i].message.messageID, *messageID, messageIDMask)) {
+            canLatest[i].unread = 0;
+            *messageID = canLatest[i].message.messageID;
+            memcpy(data, canLatest[i].message.data, canLatest[i].message.dataSize);
+            *dataSize = canLatest[i].message.dataSize;
+            *timeStamp = canLatest[i].message.timeStamp;
+            *status = 0;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_CAN_OpenStreamSession(uint32_t* sessionHandle, uint32_t messageID, uint32_t messageIDMask,
+                               uint32_t maxMessages, int32_t* status) {
+    pthread_mutex_lock(&mutex);
+    for (int i = 0; i < MAX_CAN_SESSIONS; i++) {
+        if (!canSessions[i].used) {
+            memset(&canSessions[i], 0, sizeof(canSessions[i]));
+            canSessions[i].used = 1;
+            canSessions[i].messageID = messageID;
+            canSessions[i].messageIDMask = messageIDMask;
+            canSessions[i].queue.capacity = maxMessages == 0 || maxMessages > CAN_QUEUE_SIZE ? CAN_QUEUE_SIZE : maxMessages;
+            pthread_mutex_unlock(&mutex);
+            *sessionHandle = i + 1;
+            *status = 0;
+            return;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    *status = NO_AVAILABLE_RESOURCES;
+}
+
+void HAL_CAN_CloseStreamSession(uint32_t sessionHandle) {
+    if (sessionHandle == 0 || sessionHandle > MAX_CAN_SESSIONS) return;
+    pthread_mutex_lock(&mutex);
+    canSessions[sessionHandle - 1].used = 0;
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_CAN_ReadStreamSession(uint32_t sessionHandle, struct HAL_CANStreamMessage* messages, uint32_t messagesToRead,
+                               uint32_t* messagesRead, int32_t* status) {
+    *messagesRead = 0;
+    if (sessionHandle == 0 || sessionHandle > MAX_CAN_SESSIONS || !canSessions[sessionHandle - 1].used) {
+        *status = HAL_ERR_CANSessionMux_NotAllowed;
+        return;
+    }
+    pthread_mutex_lock(&mutex);
+    while (*messagesRead < messagesToRead && canPop(&canSessions[sessionHandle - 1].queue, &messages[*messagesRead])) {
+        (*messagesRead)++;
+    }
+    *status = canSessions[sessionHandle - 1].overrun ? HAL_ERR_CANSessionMux_SessionOverrun : 0;
+    canSessions[sessionHandle - 1].overrun = 0;
+    if (*messagesRead == 0 && *status == 0) *status = HAL_ERR_CANSessionMux_MessageNotFound;
+    pthread_mutex_unlock(&mutex);
+}
+
+void HAL_CAN_GetCANStatus(float* percentBusUtilization, uint32_t* busOffCount, uint32_t* txFullCount,
+                          uint32_t* receiveErrorCount, uint32_t* transmitErrorCount, int32_t* status) {
+    *percentBusUtilization = 0;
+    *busOffCount = *txFullCount = *receiveErrorCount = *transmitErrorCount = 0;
+    *status = 0;
+}
@@ -0,0 +1,165 @@
+//go:build sim
+// +build sim
+
+// Package halsim is a desktop replacement for the roboRIO HAL, linked in with the sim build tag.
+// The functions here drive the simulated driver station and devices and read back what the robot wrote
+package halsim
+
+// #cgo CFLAGS: -I${SRCDIR}/../include -I${SRCDIR}/include
+// #cgo LDFLAGS: -lpthread
+// #include <stdlib.h>
+// #include "halsim.h"
+import "C"
+import (
+	"math"
+	"unsafe"
+)
+
+const (
+	PDPChannels = 16
+)
+
+type ControlWord struct {
+	Enabled, Autonomous, Test, EStop, FMSAttached, DSAttached bool
+}
+
+var (
+	DisabledMode   = ControlWord{DSAttached: true}
+	AutonomousMode = ControlWord{Enabled: true, Autonomous: true, DSAttached: true}
+	TeleopMode     = ControlWord{Enabled: true, DSAttached: true}
+	TestMode       = ControlWord{Enabled: true, Test: true, DSAttached: true}
+)
+
+// Stops time from following the wall clock, it then only moves forward through Step.
+// Call before starting the loop to run it faster than real time
+func SetSteppedClock(enabled bool) {
+	C.HALSIM_SetSteppedClock(cBool(enabled))
+}
+
+// Jumps the clock to the next notifier alarm the given number of times. Every alarm is one tick of the loop or of a
+// task, so this is only a count of loop ticks while no task is running beside the loop, use StepTime otherwise.
+// Blocks until the last tick has finished and returns the FPGA time in microseconds
+func Step(alarms int) uint64 {
+	return uint64(C.HALSIM_Step(C.int32_t(alarms)))
+}
+
+// Moves the clock forward by seconds, running every tick of the loop and of any task due in that time in order.
+// Blocks until they have finished and returns the FPGA time in microseconds
+func StepTime(seconds float64) uint64 {
+	return uint64(C.HALSIM_StepTime(C.uint64_t(math.Round(seconds * 1e6))))
+}
+
+// Stops every notifier, which makes frc.Start return
+func Shutdown() {
+	C.HALSIM_ShutdownNotifiers()
+}
+
+func cBool(b bool) C.int32_t {
+	if b {
+		return 1
+	}
+	return 0
+}
+
+func SetControlWord(word ControlWord) {
+	C.HALSIM_SetControlWord(cBool(word.Enabled), cBool(word.Autonomous), cBool(word.Test), cBool(word.EStop),
+		cBool(word.FMSAttached), cBool(word.DSAttached))
+}
+
+func SetJoystickAxes(joystick int, axes ...float32) {
+	var first *C.float
+	if len(axes) > 0 {
+		first = (*C.float)(unsafe.Pointer(&axes[0]))
+	}
+	C.HALSIM_SetJoystickAxes(C.int32_t(joystick), first, C.int32_t(len(axes)))
+}
+
+// Energy is integrated from the previous currents over the time since the last call
+func SetPDP(voltage float64, channelCurrents []float64) {
+	var first *C.double
+	if len(channelCurrents) > 0 {
+		first = (*C.double)(unsafe.Pointer(&channelCurrents[0]))
+	}
+	C.HALSIM_SetPDP(C.double(voltage), first, C.int32_t(len(channelCurrents)))
+}
+
+func PWMSpeed(channel int) float64 {
+	return float64(C.HALSIM_GetPWMSpeed(C.int32_t(channel)))
+}
+
+func Solenoids(module int) int32 {
+	return int32(C.HALSIM_GetSolenoids(C.int32_t(module)))
+}
+
+// Master side of the pseudo terminal backing a serial port, -1 until the robot opens the port
+func SerialMasterFD(port int) int {
+	return int(C.HALSIM_GetSerialMasterFD(C.int32_t(port)))
+}
+
+// Every transaction with the device will read back data, a device that was never set does not acknowledge
+func SetI2CData(port, address int, data []byte) {
+	var first *C.uint8_t
+	if len(data) > 0 {
+		first = (*C.uint8_t)(unsafe.Pointer(&data[0]))
+	}
+	C.HALSIM_SetI2CData(C.int32_t(port), C.int32_t(address), first, C.int32_t(len(data)))
+}
+
+// Handle to a value of a HAL sim device, zero if it was not found
+type SimValue int32
+
+func FindSimValue(device, name string) SimValue {
+	cDevice, cName := C.CString(device), C.CString(name)
+	defer C.free(unsafe.Pointer(cDevice))
+	defer C.free(unsafe.Pointer(cName))
+	return SimValue(C.HALSIM_FindSimValue(cDevice, cName))
+}
+
+func (value SimValue) Get() float64 {
+	var result C.double
+	C.HALSIM_GetSimDoubles((*C.int32_t)(unsafe.Pointer(&value)), &result, 1)
+	return float64(result)
+}
+
+func (value SimValue) Set(newValue float64) {
+	cValue := C.double(newValue)
+	C.HALSIM_SetSimDoubles((*C.int32_t)(unsafe.Pointer(&value)), &cValue, 1)
+}
+
+// Reads all of the values with a single call into C
+func GetSimDoubles(values []SimValue, results []float64) {
+	if len(values) > 0 {
+		C.HALSIM_GetSimDoubles((*C.int32_t)(unsafe.Pointer(&values[0])), (*C.double)(unsafe.Pointer(&results[0])), C.int32_t(len(values)))
+	}
+}
+
+func SetSimDoubles(values []SimValue, newValues []float64) {
+	if len(values) > 0 {
+		C.HALSIM_SetSimDoubles((*C.int32_t)(unsafe.Pointer(&values[0])), (*C.double)(unsafe.Pointer(&newValues[0])), C.int32_t(len(values)))
+	}
+}
+
+// Delivers a frame to the robot as if a device on the bus had sent it
+func InjectCANFrame(messageID uint32, data []byte) {
+	var first *C.uint8_t
+	if len(data) > 0 {
+		first = (*C.uint8_t)(unsafe.Pointer(&data[0]))
+	}
+	C.HALSIM_InjectCANFrame(C.uint32_t(messageID), first, C.uint8_t(len(data)))
+}
+
+type CANFrame struct {
+	MessageID uint32
+	Data      [8]byte
+	Size      uint8
+	TimeStamp uint32 // Milliseconds
+}
+
+// Next frame the robot sent, false when there are none left
+func ReadSentCANFrame(frame *CANFrame) bool {
+	var size C.uint8_t
+	var messageID, timeStamp C.uint32_t
+	read := C.HALSIM_ReadSentCANFrame(&messageID, (*C.uint8_t)(unsafe.Pointer(&frame.Data[0])), &size, &timeStamp)
+	frame.MessageID, frame.Size, frame.TimeStamp = uint32(messageID), uint8(size), uint32(timeStamp)
+	return read != 0
+}
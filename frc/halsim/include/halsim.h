@@ -0,0 +1,47 @@
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Clock
+void HALSIM_SetSteppedClock(int32_t enabled);
+
+uint64_t HALSIM_Step(int32_t alarms);
+uint64_t HALSIM_StepTime(uint64_t microseconds);
+
+void HALSIM_ShutdownNotifiers(void);
+
+// Driver station
+void HALSIM_SetControlWord(int32_t enabled, int32_t autonomous, int32_t test, int32_t eStop, int32_t fmsAttached, int32_t dsAttached);
+
+void HALSIM_SetJoystickAxes(int32_t joystick, const float* axes, int32_t count);
+
+// Power
+void HALSIM_SetPDP(double voltage, const double* channelCurrents, int32_t count);
+
+// Outputs written by the robot
+double HALSIM_GetPWMSpeed(int32_t channel);
+
+int32_t HALSIM_GetSolenoids(int32_t module);
+
+// Inputs read by the robot
+int HALSIM_GetSerialMasterFD(int32_t port);
+
+void HALSIM_SetI2CData(int32_t port, int32_t address, const uint8_t* data, int32_t size);
+
+// Sim devices, values are looked up by device and value name like "Talon SRX[1]" and "Output"
+int32_t HALSIM_FindSimValue(const char* device, const char* name);
+
+void HALSIM_GetSimDoubles(const int32_t* handles, double* values, int32_t count);
+
+void HALSIM_SetSimDoubles(const int32_t* handles, const double* values, int32_t count);
+
+// CAN, frames injected here are received by the robot, frames sent by the robot are read back here
+void HALSIM_InjectCANFrame(uint32_t messageID, const uint8_t* data, uint8_t dataSize);
+
+int32_t HALSIM_ReadSentCANFrame(uint32_t* messageID, uint8_t* data, uint8_t* dataSize, uint32_t* timeStamp);
+
+#ifdef __cplusplus
+}
+#endif
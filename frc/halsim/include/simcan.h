@@ -0,0 +1,31 @@
+#include <string.h>
+
+#include "hal/CAN.h"
+
+// CAN frames of the simulated motor controllers. They send a control frame each time they are set, as the real
+// ones are told what to do over the bus, and take their sensor values from a status frame whenever the bus has a
+// newer one than they last read. Nothing sends status frames in a plain simulation, so the physics models drive the
+// sensors, but frames injected by a CAN log replay override them like a real controller's measurements would
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void SimSendFrame(uint32_t messageID, const uint8_t* data, uint8_t dataSize) {
+    int32_t status = 0;
+    HAL_CAN_SendMessage(messageID, data, dataSize, HAL_CAN_SEND_PERIOD_NO_REPEAT, &status);
+}
+
+// Fills data with the frame and returns true when one with this ID arrived since the last call
+static inline int SimReceiveFrame(uint32_t messageID, uint8_t data[8]) {
+    uint8_t size = 0;
+    uint32_t timeStamp = 0;
+    int32_t status = 0;
+    memset(data, 0, 8);
+    HAL_CAN_ReceiveMessage(&messageID, 0x1FFFFFFF, data, &size, &timeStamp, &status);
+    return status == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
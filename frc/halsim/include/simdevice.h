@@ -0,0 +1,41 @@
+#include "hal/Types.h"
+#include "hal/Value.h"
+
+// The C part of hal/SimDevice.h, which cannot be included from C++ here since its wrappers need wpiutil
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HAL_SimDeviceHandle HAL_CreateSimDevice(const char* name);
+
+void HAL_FreeSimDevice(HAL_SimDeviceHandle handle);
+
+HAL_SimValueHandle HAL_CreateSimValue(HAL_SimDeviceHandle device, const char* name, HAL_Bool readonly,
+                                      const struct HAL_Value* initialValue);
+
+void HAL_GetSimValue(HAL_SimValueHandle handle, struct HAL_Value* value);
+
+void HAL_SetSimValue(HAL_SimValueHandle handle, const struct HAL_Value* value);
+
+static inline HAL_SimValueHandle SimCreateDouble(HAL_SimDeviceHandle device, const char* name, HAL_Bool readonly,
+                                                 double initialValue) {
+    struct HAL_Value value = HAL_MakeDouble(initialValue);
+    return HAL_CreateSimValue(device, name, readonly, &value);
+}
+
+static inline double SimGetDouble(HAL_SimValueHandle handle) {
+    struct HAL_Value value;
+    value.data.v_double = 0;
+    HAL_GetSimValue(handle, &value);
+    return value.data.v_double;
+}
+
+static inline void SimSetDouble(HAL_SimValueHandle handle, double value) {
+    struct HAL_Value halValue = HAL_MakeDouble(value);
+    HAL_SetSimValue(handle, &halValue);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,107 @@
+package frc
+
+import (
+	"fmt"
+	"math"
+	"strings"
+)
+
+// Fixed bucket histogram, Add never allocates so it is safe to use on the loop thread
+type Histogram struct {
+	Bounds   []float64 // Inclusive upper bound of each bucket, values above the last bound go in the overflow bucket
+	Counts   []uint64  // One longer than Bounds, the last element is the overflow bucket
+	Total    uint64
+	Sum      float64
+	Min, Max float64
+}
+
+// Bounds start, start*factor, start*factor^2, ... with count entries
+func ExponentialBounds(start, factor float64, count int) []float64 {
+	bounds := make([]float64, count)
+	for i := range bounds {
+		bounds[i] = start
+		start *= factor
+	}
+	return bounds
+}
+
+func NewHistogram(bounds []float64) *Histogram {
+	return &Histogram{Bounds: bounds, Counts: make([]uint64, len(bounds)+1), Min: math.Inf(1), Max: math.Inf(-1)}
+}
+
+func (histogram *Histogram) Add(value float64) {
+	bucket := len(histogram.Bounds)
+	for i, bound := range histogram.Bounds {
+		if value <= bound {
+			bucket = i
+			break
+		}
+	}
+	histogram.Counts[bucket]++
+	histogram.Total++
+	histogram.Sum += value
+	histogram.Min = math.Min(histogram.Min, value)
+	histogram.Max = math.Max(histogram.Max, value)
+}
+
+func (histogram *Histogram) Reset() {
+	for i := range histogram.Counts {
+		histogram.Counts[i] = 0
+	}
+	histogram.Total, histogram.Sum = 0, 0
+	histogram.Min, histogram.Max = math.Inf(1), math.Inf(-1)
+}
+
+// Copies into other, reusing its slices when they are big enough
+func (histogram *Histogram) CopyTo(other *Histogram) {
+	other.Bounds = append(other.Bounds[:0], histogram.Bounds...)
+	other.Counts = append(other.Counts[:0], histogram.Counts...)
+	other.Total, other.Sum, other.Min, other.Max = histogram.Total, histogram.Sum, histogram.Min, histogram.Max
+}
+
+func (histogram *Histogram) Mean() float64 {
+	if histogram.Total == 0 {
+		return 0
+	}
+	return histogram.Sum / float64(histogram.Total)
+}
+
+// Upper bound of the bucket containing the quantile, so it over-estimates by at most one bucket
+func (histogram *Histogram) Quantile(quantile float64) float64 {
+	if histogram.Total == 0 {
+		return 0
+	}
+	target := uint64(math.Ceil(quantile * float64(histogram.Total)))
+	seen := uint64(0)
+	for i, count := range histogram.Counts {
+		seen += count
+		if seen >= target && i < len(histogram.Bounds) {
+			return math.Min(histogram.Bounds[i], histogram.Max)
+		}
+	}
+	return histogram.Max
+}
+
+// Scale converts values for printing, for example 1e6 to show seconds as microseconds
+func (histogram *Histogram) Format(scale float64, unit string) string {
+	var builder strings.Builder
+	fmt.Fprintf(&builder, "n=%d mean=%.1f%s min=%.1f%s p50=%.1f%s p99=%.1f%s max=%.1f%s\n", histogram.Total,
+		histogram.Mean()*scale, unit, histogram.Min*scale, unit, histogram.Quantile(0.5)*scale, unit,
+		histogram.Quantile(0.99)*scale, unit, histogram.Max*scale, unit)
+	lower := math.Inf(-1)
+	for i, count := range histogram.Counts {
+		if count == 0 {
+			if i < len(histogram.Bounds) {
+				lower = histogram.Bounds[i]
+			}
+			continue
+		}
+		if i < len(histogram.Bounds) {
+			fmt.Fprintf(&builder, "  (%.1f, %.1f]%s\t%d\n", lower*scale, histogram.Bounds[i]*scale, unit, count)
+			lower = histogram.Bounds[i]
+		} else {
+			fmt.Fprintf(&builder, "  > %.1f%s\t%d\n", lower*scale, unit, count)
+		}
+	}
+	return builder.String()
+}
@@ -0,0 +1,156 @@
+package frc
+
+// #include "hal.h"
+import "C"
+import (
+	"runtime"
+	"sync"
+	"time"
+	"unsafe"
+)
+
+const (
+	I2COnboard = C.HAL_I2C_kOnboard
+	I2CMXP     = C.HAL_I2C_kMXP
+)
+
+var (
+	// Microseconds to tens of milliseconds, where I2C transactions on the roboRIO land
+	I2CLatencyBounds = ExponentialBounds(50e-6, 1.5, 16)
+)
+
+// Runs every transaction for the devices on one port from a dedicated thread.
+// Transactions take milliseconds, so the loop only ever reads results that are already done
+type I2CBus struct {
+	port    C.HAL_I2CPort
+	mutex   sync.Mutex
+	devices []*I2CDevice
+	wake    chan struct{}
+	stop    chan struct{}
+}
+
+// Polls a device by writing Write and reading back ReadSize bytes every period.
+// Results are double buffered: the worker reads into the back buffer and swaps under a lock held only for the swap
+type I2CDevice struct {
+	address  int
+	period   time.Duration
+	write    []byte
+	buffers  [2][]byte
+	front    int
+	due      time.Time
+	mutex    sync.Mutex
+	time     float64
+	ok       bool
+	failures uint64
+	latency  *Histogram
+}
+
+func NewI2CBus(port int) *I2CBus {
+	status := C.int32_t(0)
+	C.HAL_InitializeI2C(C.HAL_I2CPort(port), &status)
+	handleErrorStatus(status)
+	bus := &I2CBus{port: C.HAL_I2CPort(port), wake: make(chan struct{}, 1), stop: make(chan struct{})}
+	go bus.run()
+	return bus
+}
+
+func (bus *I2CBus) AddDevice(address int, write []byte, readSize int, period time.Duration) *I2CDevice {
+	device := &I2CDevice{
+		address: address,
+		period:  period,
+		write:   append([]byte(nil), write...),
+		buffers: [2][]byte{make([]byte, readSize), make([]byte, readSize)},
+		latency: NewHistogram(I2CLatencyBounds),
+	}
+	bus.mutex.Lock()
+	bus.devices = append(bus.devices, device)
+	bus.mutex.Unlock()
+	select {
+	case bus.wake <- struct{}{}:
+	default:
+	}
+	return device
+}
+
+func (bus *I2CBus) run() {
+	// The transactions block in the kernel, keep them from sharing a thread with anything else
+	runtime.LockOSThread()
+	timer := time.NewTimer(time.Hour)
+	for {
+		bus.mutex.Lock()
+		devices := bus.devices
+		bus.mutex.Unlock()
+		next := time.Now().Add(time.Hour)
+		for _, device := range devices {
+			if now := time.Now(); !now.Before(device.due) {
+				bus.poll(device)
+				device.due = now.Add(device.period)
+			}
+			if device.due.Before(next) {
+				next = device.due
+			}
+		}
+		timer.Reset(time.Until(next))
+		select {
+		case <-bus.stop:
+			timer.Stop()
+			C.HAL_CloseI2C(bus.port)
+			return
+		case <-bus.wake:
+			if !timer.Stop() {
+				<-timer.C
+			}
+		case <-timer.C:
+		}
+	}
+}
+
+func (bus *I2CBus) poll(device *I2CDevice) {
+	back := device.buffers[1-device.front]
+	var send, receive *C.uint8_t
+	if len(device.write) > 0 {
+		send = (*C.uint8_t)(unsafe.Pointer(&device.write[0]))
+	}
+	if len(back) > 0 {
+		receive = (*C.uint8_t)(unsafe.Pointer(&back[0]))
+	}
+	start := time.Now()
+	result := C.HAL_TransactionI2C(bus.port, C.int32_t(device.address), send, C.int32_t(len(device.write)), receive, C.int32_t(len(back)))
+	latency := time.Since(start).Seconds()
+	now := getFPGATime()
+	device.mutex.Lock()
+	device.latency.Add(latency)
+	if result < 0 {
+		device.failures++
+	} else {
+		device.front = 1 - device.front
+		device.time, device.ok = now, true
+	}
+	device.mutex.Unlock()
+}
+
+func (bus *I2CBus) Close() {
+	close(bus.stop)
+}
+
+// Copies the most recent result into destination without waiting on the bus.
+// Returns the FPGA time it was read at, and false if no transaction has succeeded yet
+func (device *I2CDevice) Latest(destination []byte) (float64, bool) {
+	device.mutex.Lock()
+	defer device.mutex.Unlock()
+	copy(destination, device.buffers[device.front])
+	return device.time, device.ok
+}
+
+// Copies the transaction latency histogram in seconds, pass the same histogram each time to avoid allocating
+func (device *I2CDevice) Latency(histogram *Histogram) {
+	device.mutex.Lock()
+	defer device.mutex.Unlock()
+	device.latency.CopyTo(histogram)
+}
+
+func (device *I2CDevice) Failures() uint64 {
+	device.mutex.Lock()
+	defer device.mutex.Unlock()
+	return device.failures
+}
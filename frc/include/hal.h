@@ -1,3 +1,10 @@
  #include "hal/HALBase.h"
  #include "hal/Notifier.h"
  #include "hal/DriverStation.h"
+ #include "hal/PDP.h"
+ #include "hal/Solenoid.h"
+ #include "hal/Compressor.h"
+ #include "hal/SerialPort.h"
+ #include "hal/I2C.h"
+ #include "hal/PWM.h"
+ #include "hal/CAN.h"
@@ -0,0 +1,26 @@
+#ifndef FRC_TRACE_H
+#define FRC_TRACE_H
+
+// Records a trace event, phase is 'B' when something begins and 'E' when it ends. The name must stay valid
+typedef void (*TraceHook)(const char* name, char phase);
+
+#ifdef __cplusplus
+#include <atomic>
+
+// Traces the enclosing scope through hook, which is null while tracing is off so that only costs a branch
+struct TraceScope {
+    TraceHook hook;
+    const char* name;
+
+    TraceScope(const std::atomic<TraceHook>& current, const char* name)
+        : hook(current.load(std::memory_order_relaxed)), name(name) {
+        if (hook) hook(name, 'B');
+    }
+
+    ~TraceScope() {
+        if (hook) hook(name, 'E');
+    }
+};
+#endif
+
+#endif
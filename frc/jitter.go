@@ -0,0 +1,104 @@
+package frc
+
+import (
+	"fmt"
+	"runtime"
+	"sync"
+	"sync/atomic"
+)
+
+// Set Ticks before Start to measure how late each timing source wakes the loop instead of running the robot.
+// Every source is measured idle, with all but one of Go's Ps spinning and with an allocating goroutine keeping the GC busy
+type JitterConfig struct {
+	Ticks  int     // Per source and load, zero runs the robot as usual
+	Period float64 // Seconds
+}
+
+var (
+	JitterCheck = JitterConfig{Period: Period}
+	// Ten microseconds to tens of milliseconds, from a good wake-up to a missed tick
+	JitterBounds = ExponentialBounds(10e-6, 1.5, 20)
+)
+
+var jitterSources = []struct {
+	name     string
+	newTimer func(period float64) LoopTimer
+}{
+	{"HAL notifier", newNotifierTimer},
+	{"Go ticker", newTickerTimer},
+	{"timerfd", newTimerFDTimer},
+}
+
+var jitterLoads = []struct {
+	name  string
+	start func(stop *int32, group *sync.WaitGroup)
+}{
+	{"idle", func(*int32, *sync.WaitGroup) {}},
+	{"CPU load", spinLoad},
+	{"GC load", garbageLoad},
+}
+
+// Prints a histogram of wake-up lateness for every source under every load
+func runJitterCheck(config JitterConfig) {
+	histogram := NewHistogram(JitterBounds)
+	for _, load := range jitterLoads {
+		for _, source := range jitterSources {
+			stop := int32(0)
+			var group sync.WaitGroup
+			load.start(&stop, &group)
+			histogram.Reset()
+			measureJitter(source.newTimer(config.Period), config.Ticks, histogram)
+			atomic.StoreInt32(&stop, 1)
+			group.Wait()
+			fmt.Printf("%s, %s, %.1fms period\n%s", source.name, load.name, config.Period*1e3, histogram.Format(1e6, "us"))
+		}
+	}
+}
+
+// Lateness of every tick the loop has run, only read it from the loop thread or after Start returns
+func LoopJitter() *Histogram {
+	return loopJitter
+}
+
+func measureJitter(timer LoopTimer, ticks int, histogram *Histogram) {
+	defer timer.Close()
+	for i := 0; i < ticks; i++ {
+		lateness, ok := timer.Wait()
+		if !ok {
+			return
+		}
+		histogram.Add(lateness)
+	}
+}
+
+// Spins on every P but one. Go 1.13 cannot preempt a loop without calls, so each spinner yields between short
+// chunks of work, otherwise it would hold its P until stopped and starve the Go ticker and the GC
+func spinLoad(stop *int32, group *sync.WaitGroup) {
+	spinners := runtime.GOMAXPROCS(0) - 1
+	if spinners < 1 {
+		spinners = 1
+	}
+	for i := 0; i < spinners; i++ {
+		group.Add(1)
+		go func() {
+			defer group.Done()
+			for atomic.LoadInt32(stop) == 0 {
+				for j := 0; j < 100000; j++ {
+				}
+				runtime.Gosched()
+			}
+		}()
+	}
+}
+
+// Keeps some garbage alive so every cycle has marking to do, not just an empty heap to sweep
+func garbageLoad(stop *int32, group *sync.WaitGroup) {
+	group.Add(1)
+	go func() {
+		defer group.Done()
+		live := make([][]byte, 256)
+		for i := 0; atomic.LoadInt32(stop) == 0; i++ {
+			live[i%len(live)] = make([]byte, 64*1024)
+		}
+	}()
+}
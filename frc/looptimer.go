@@ -0,0 +1,183 @@
+package frc
+
+/*
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include "hal.h"
+
+// Absolute CLOCK_MONOTONIC timer firing every period, starting one period from now.
+// This gives the same fixed deadlines as clock_nanosleep with TIMER_ABSTIME, and also counts missed periods
+static int openTimerFD(int64_t periodNs, int64_t* startNs) {
+	int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	if (fd < 0) return -1;
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	*startNs = (int64_t) now.tv_sec * 1000000000 + now.tv_nsec + periodNs;
+	struct itimerspec spec = {
+		{periodNs / 1000000000, periodNs % 1000000000},
+		{*startNs / 1000000000, *startNs % 1000000000},
+	};
+	if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// Blocks until the timer fires, returns how many periods elapsed and when the thread woke up
+static uint64_t waitTimerFD(int fd, int64_t* wokeNs) {
+	uint64_t expirations = 0;
+	if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) expirations = 0;
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	*wokeNs = (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+	return expirations;
+}
+
+static int setRealtimePriority(int priority, int* oldPolicy, int* oldPriority) {
+	struct sched_param param;
+	pthread_getschedparam(pthread_self(), oldPolicy, &param);
+	*oldPriority = param.sched_priority;
+	param.sched_priority = priority;
+	return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+}
+
+static void restorePriority(int policy, int priority) {
+	struct sched_param param = {.sched_priority = priority};
+	pthread_setschedparam(pthread_self(), policy, &param);
+}
+*/
+import "C"
+import (
+	"fmt"
+	"time"
+)
+
+// Wakes the loop once per period on fixed deadlines, so a slow tick does not push back the ones after it
+type LoopTimer interface {
+	// Blocks until the next tick is due and returns how many seconds after the deadline it woke up, false once the
+	// timer has been stopped. Every timer reads its clock after the waiting thread runs again and subtracts the
+	// deadline, so lateness includes waking the thread and the sources can be compared
+	Wait() (lateness float64, ok bool)
+	Close()
+}
+
+// The timer the HAL provides, the only one the stepped simulation clock can drive
+type notifierTimer struct {
+	notifier   C.HAL_NotifierHandle
+	expiration C.uint64_t
+	period     C.uint64_t
+}
+
+func newNotifierTimer(period float64) LoopTimer {
+	status := C.int32_t(0)
+	timer := &notifierTimer{notifier: C.HAL_InitializeNotifier(&status), period: C.uint64_t(period * 1e6)}
+	handleErrorStatus(status)
+	timer.expiration = C.uint64_t(getFPGATime()*1e6) + timer.period
+	C.HAL_UpdateNotifierAlarm(timer.notifier, timer.expiration, &status)
+	handleErrorStatus(status)
+	return timer
+}
+
+func (timer *notifierTimer) Wait() (float64, bool) {
+	status := C.int32_t(0)
+	if C.HAL_WaitForNotifierAlarm(timer.notifier, &status) == 0 || status != 0 {
+		return 0, false
+	}
+	// What the wait returns is when the notifier's own thread fired, before this thread was woken
+	lateness := getFPGATime() - float64(timer.expiration)*1e-6
+	timer.expiration += timer.period
+	C.HAL_UpdateNotifierAlarm(timer.notifier, timer.expiration, &status)
+	handleErrorStatus(status)
+	return lateness, true
+}
+
+func (timer *notifierTimer) Close() {
+	status := C.int32_t(0)
+	C.HAL_StopNotifier(timer.notifier, &status)
+	C.HAL_CleanNotifier(timer.notifier, &status)
+}
+
+// SCHED_FIFO priority of the thread waiting on a timerfd, above normal threads and below the kernel's IRQ threads
+const LoopPriority = 40
+
+// A timerfd on the calling thread, for Linux boards without the roboRIO's notifier.
+// The thread is moved to SCHED_FIFO, which needs CAP_SYS_NICE, so the loop is not stuck behind other programs
+type timerFDTimer struct {
+	fd                     C.int
+	period, due            C.int64_t
+	prioritySet, realtime  bool
+	oldPolicy, oldPriority C.int
+}
+
+func newTimerFDTimer(period float64) LoopTimer {
+	timer := &timerFDTimer{period: C.int64_t(period * 1e9)}
+	timer.fd = C.openTimerFD(timer.period, &timer.due)
+	if timer.fd < 0 {
+		panic("timerfd is not available")
+	}
+	return timer
+}
+
+func (timer *timerFDTimer) Wait() (float64, bool) {
+	// The priority belongs to whichever thread waits, which is only known once the loop calls this
+	if !timer.prioritySet {
+		timer.prioritySet = true
+		if errno := C.setRealtimePriority(LoopPriority, &timer.oldPolicy, &timer.oldPriority); errno != 0 {
+			fmt.Println("Could not make the loop thread realtime, errno", errno)
+		} else {
+			timer.realtime = true
+		}
+	}
+	var woke C.int64_t
+	expirations := C.waitTimerFD(timer.fd, &woke)
+	if expirations == 0 {
+		return 0, false
+	}
+	// More than one expiration means whole periods were missed, lateness is measured from the latest one
+	timer.due += C.int64_t(expirations-1) * timer.period
+	lateness := float64(woke-timer.due) * 1e-9
+	timer.due += timer.period
+	return lateness, true
+}
+
+// Call from the thread that waited, it gets its old priority back
+func (timer *timerFDTimer) Close() {
+	if timer.realtime {
+		C.restorePriority(timer.oldPolicy, timer.oldPriority)
+	}
+	C.close(timer.fd)
+}
+
+// A Go time.Ticker, only used for comparison by the jitter check
+type tickerTimer struct {
+	ticker   *time.Ticker
+	start    time.Time
+	interval time.Duration
+	ticks    time.Duration
+}
+
+func newTickerTimer(period float64) LoopTimer {
+	interval := time.Duration(period * float64(time.Second))
+	return &tickerTimer{ticker: time.NewTicker(interval), start: time.Now(), interval: interval}
+}
+
+func (timer *tickerTimer) Wait() (float64, bool) {
+	<-timer.ticker.C
+	timer.ticks++
+	// The ticker drops ticks a slow reader missed, so lateness is measured from the latest one that was due
+	elapsed := time.Since(timer.start)
+	due := elapsed / timer.interval * timer.interval
+	if due < timer.ticks*timer.interval {
+		due = timer.ticks * timer.interval
+	}
+	return (elapsed - due).Seconds(), true
+}
+
+func (timer *tickerTimer) Close() {
+	timer.ticker.Stop()
+}
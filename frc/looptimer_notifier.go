@@ -0,0 +1,9 @@
+//go:build !timerfd
+// +build !timerfd
+
+package frc
+
+// The loop runs on the HAL notifier unless built with the timerfd tag
+func newLoopTimer(period float64) LoopTimer {
+	return newNotifierTimer(period)
+}
@@ -0,0 +1,10 @@
+//go:build timerfd
+// +build timerfd
+
+package frc
+
+// Built with the timerfd tag the loop no longer needs a working notifier, only a HAL for everything else.
+// The stepped simulation clock cannot drive it
+func newLoopTimer(period float64) LoopTimer {
+	return newTimerFDTimer(period)
+}
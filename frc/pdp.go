@@ -0,0 +1,177 @@
+package frc
+
+// #include "hal.h"
+import "C"
+import (
+	"sync"
+	"time"
+)
+
+const (
+	PDPChannels = 16
+
+	BrownoutVoltage = 6.8 // Volts, where the roboRIO starts disabling outputs
+)
+
+// Latest values read from the PDP by the background sampler
+type PDPSnapshot struct {
+	Time            float64 // FPGA time in seconds of when the sample finished
+	Voltage         float64
+	TotalCurrent    float64
+	TotalEnergy     float64 // Joules since the PDP was last reset
+	ChannelCurrents [PDPChannels]float64
+	BrownedOut      bool
+}
+
+type PDP struct {
+	handle   C.HAL_PDPHandle
+	mutex    sync.Mutex
+	snapshot PDPSnapshot
+	errors   int
+	stop     chan struct{}
+	done     chan struct{} // Closed when the sampler has stopped using the handle
+}
+
+// Starts a goroutine which reads every channel of the PDP once per period.
+// Every read is a CAN transaction, so doing all of them on the loop thread would eat into the tick
+func NewPDP(module int, period time.Duration) *PDP {
+	status := C.int32_t(0)
+	handle := C.HAL_InitializePDP(C.int32_t(module), &status)
+	handleErrorStatus(status)
+	pdp := &PDP{handle: handle, stop: make(chan struct{}), done: make(chan struct{})}
+	go pdp.run(period)
+	return pdp
+}
+
+func (pdp *PDP) run(period time.Duration) {
+	defer close(pdp.done)
+	ticker := time.NewTicker(period)
+	defer ticker.Stop()
+	var sample PDPSnapshot
+	for {
+		select {
+		case <-pdp.stop:
+			return
+		case <-ticker.C:
+		}
+		ok := pdp.sample(&sample)
+		pdp.mutex.Lock()
+		if ok {
+			pdp.snapshot = sample
+		} else {
+			pdp.errors++
+		}
+		pdp.mutex.Unlock()
+	}
+}
+
+// A failed read is counted instead of panicking, a missed CAN frame should not kill the robot. False when any read
+// failed, the sample is then skipped so the limiter never acts on an old value under a new time
+func (pdp *PDP) sample(sample *PDPSnapshot) bool {
+	status := C.int32_t(0)
+	if sample.Voltage = float64(C.HAL_GetPDPVoltage(pdp.handle, &status)); status != 0 {
+		return false
+	}
+	if sample.TotalCurrent = float64(C.HAL_GetPDPTotalCurrent(pdp.handle, &status)); status != 0 {
+		return false
+	}
+	if sample.TotalEnergy = float64(C.HAL_GetPDPTotalEnergy(pdp.handle, &status)); status != 0 {
+		return false
+	}
+	for channel := 0; channel < PDPChannels; channel++ {
+		current := C.HAL_GetPDPChannelCurrent(pdp.handle, C.int32_t(channel), &status)
+		if status != 0 {
+			return false
+		}
+		sample.ChannelCurrents[channel] = float64(current)
+	}
+	if sample.BrownedOut = C.HAL_GetBrownedOut(&status) != 0; status != 0 {
+		return false
+	}
+	now := C.HAL_GetFPGATime(&status)
+	if status != 0 {
+		return false
+	}
+	sample.Time = float64(now) * 1e-6
+	return true
+}
+
+// Copy of the most recent sample where every read succeeded, safe to call from the loop thread. Its Time says how old
+// it is when samples are being skipped
+func (pdp *PDP) Snapshot() PDPSnapshot {
+	pdp.mutex.Lock()
+	defer pdp.mutex.Unlock()
+	return pdp.snapshot
+}
+
+// Number of samples skipped because a read from the PDP or of the FPGA time failed
+func (pdp *PDP) Errors() int {
+	pdp.mutex.Lock()
+	defer pdp.mutex.Unlock()
+	return pdp.errors
+}
+
+// Waits for the sampler to finish a sample under way before freeing the handle
+func (pdp *PDP) Close() {
+	close(pdp.stop)
+	<-pdp.done
+	C.HAL_CleanPDP(pdp.handle)
+}
+
+// Scales motor outputs down when the battery voltage is trending towards a brownout.
+// Voltage and its slope are smoothed so a single noisy sample does not cut power,
+// then the voltage is extrapolated Horizon seconds ahead and compared against the limit window
+type BrownoutLimiter struct {
+	StartVoltage float64 // Predicted voltage where limiting begins
+	FloorVoltage float64 // Predicted voltage where the output reaches MinScale
+	Horizon      float64 // Seconds to look ahead
+	MinScale     float64
+	Smoothing    float64 // Weight of a new sample, between 0 and 1
+
+	lastTime, voltage, slope float64
+	initialized              bool
+}
+
+func NewBrownoutLimiter() *BrownoutLimiter {
+	return &BrownoutLimiter{
+		StartVoltage: 8.5,
+		FloorVoltage: BrownoutVoltage + 0.3,
+		Horizon:      0.2,
+		MinScale:     0.2,
+		Smoothing:    0.3,
+	}
+}
+
+// Feeds a new sample and returns the factor motor outputs should be multiplied by
+func (limiter *BrownoutLimiter) Update(snapshot PDPSnapshot) float64 {
+	if snapshot.Time == 0 {
+		return 1 // No sample yet
+	}
+	if !limiter.initialized {
+		limiter.voltage, limiter.lastTime, limiter.initialized = snapshot.Voltage, snapshot.Time, true
+	} else if dt := snapshot.Time - limiter.lastTime; dt > 0 {
+		lastVoltage := limiter.voltage
+		limiter.voltage += limiter.Smoothing * (snapshot.Voltage - limiter.voltage)
+		limiter.slope += limiter.Smoothing * ((limiter.voltage-lastVoltage)/dt - limiter.slope)
+		limiter.lastTime = snapshot.Time
+	}
+	if snapshot.BrownedOut {
+		return limiter.MinScale
+	}
+	predicted := limiter.voltage
+	if limiter.slope < 0 {
+		predicted += limiter.slope * limiter.Horizon // Only a falling voltage is extrapolated
+	}
+	return limiter.scaleFor(predicted)
+}
+
+func (limiter *BrownoutLimiter) scaleFor(voltage float64) float64 {
+	if voltage >= limiter.StartVoltage {
+		return 1
+	}
+	if voltage <= limiter.FloorVoltage {
+		return limiter.MinScale
+	}
+	fraction := (voltage - limiter.FloorVoltage) / (limiter.StartVoltage - limiter.FloorVoltage)
+	return limiter.MinScale + fraction*(1-limiter.MinScale)
+}
@@ -0,0 +1,73 @@
+package phoenix
+
+// #include "phoenix.h"
+import "C"
+import "unsafe"
+
+// What a Talon's value means, the same numbers as ctre::ControlMode
+type ControlMode int
+
+const (
+	PercentOutput ControlMode = 0
+	Position      ControlMode = 1 // Sensor position in native units, held by the Talon's own loop
+	Velocity      ControlMode = 2 // Native units per 100 ms
+)
+
+// Talons that are set and read together, each direction with one call into C however many Talons there are
+type TalonBatch struct {
+	Talons    []*Talon
+	Positions []float64 // Native units, filled in by ReadPositions
+
+	handles []unsafe.Pointer // C memory, so Go may hold them in a slice it passes to C
+	modes   []C.int
+	values  []C.double
+}
+
+func NewTalonBatch(talons ...*Talon) *TalonBatch {
+	batch := &TalonBatch{
+		Talons:    talons,
+		Positions: make([]float64, len(talons)),
+		handles:   make([]unsafe.Pointer, len(talons)),
+		modes:     make([]C.int, len(talons)),
+		values:    make([]C.double, len(talons)),
+	}
+	for i, talon := range talons {
+		batch.handles[i] = talon.handle
+	}
+	return batch
+}
+
+// Queues a value for the Talon at index i, which is applied by the next Send
+func (batch *TalonBatch) Set(i int, mode ControlMode, value float64) {
+	batch.modes[i], batch.values[i] = C.int(mode), C.double(value)
+	batch.Talons[i].mode, batch.Talons[i].output = mode, value
+}
+
+func (batch *TalonBatch) Send() {
+	if len(batch.handles) > 0 {
+		// Through a local, given &batch.handles[0] directly cgo allocates a closure to check it on every call
+		handles := &batch.handles[0]
+		C.CTRE_SetMany(handles, &batch.modes[0], &batch.values[0], C.int(len(batch.handles)))
+	}
+}
+
+func (batch *TalonBatch) ReadPositions() {
+	if len(batch.handles) > 0 {
+		handles := &batch.handles[0]
+		C.CTRE_GetSensorPositions(handles, (*C.double)(unsafe.Pointer(&batch.Positions[0])), C.int(len(batch.handles)))
+	}
+}
+
+// Send and ReadPositions with a call into C for each Talon, the crossings a batch saves, for measuring them
+func (batch *TalonBatch) SendEach() {
+	for i := range batch.handles {
+		handle := &batch.handles[i]
+		C.CTRE_SetMany(handle, &batch.modes[i], &batch.values[i], 1)
+	}
+}
+
+func (batch *TalonBatch) ReadPositionsEach() {
+	for i, talon := range batch.Talons {
+		batch.Positions[i] = talon.GetSensorPosition()
+	}
+}
@@ -0,0 +1,68 @@
+#include <cstring>
+#include <mutex>
+
+#include "errors.h"
+
+// Phoenix errors and warnings counted by code, device and function instead of being printed each time.
+// Only a new kind of error copies strings, a repeated one is a lookup and an increment
+namespace errors {
+    const int capacity = 64;
+
+    std::mutex mutex;
+    CTRE_Error table[capacity];
+    int used;
+
+    void copy(char* to, const char* from, size_t size) {
+        strncpy(to, from ? from : "", size - 1);
+        to[size - 1] = 0;
+    }
+
+    bool matches(const CTRE_Error& error, int32_t code, const char* device, const char* function) {
+        return error.code == code && strncmp(error.device, device ? device : "", sizeof(error.device) - 1) == 0 &&
+               strncmp(error.function, function ? function : "", sizeof(error.function) - 1) == 0;
+    }
+}
+
+extern "C" {
+    void CTRE_RecordError(int32_t code, const char* device, const char* function,
+                          void (*describe)(int32_t code, char* description, size_t size)) {
+        std::lock_guard<std::mutex> lock(errors::mutex);
+        CTRE_Error* error = nullptr;
+        for (int i = 0; i < errors::used; i++) {
+            if (errors::matches(errors::table[i], code, device, function)) {
+                error = &errors::table[i];
+                break;
+            }
+        }
+        if (!error && errors::used < errors::capacity - 1) {
+            error = &errors::table[errors::used++];
+            error->code = code;
+            errors::copy(error->device, device, sizeof(error->device));
+            errors::copy(error->function, function, sizeof(error->function));
+            if (describe) {
+                describe(code, error->description, sizeof(error->description));
+            }
+        } else if (!error) {
+            // The last entry counts every kind of error that did not fit
+            error = &errors::table[errors::capacity - 1];
+            error->code = CTRE_OTHER_ERRORS;
+            errors::copy(error->device, "other", sizeof(error->device));
+            errors::copy(error->description, "errors beyond the ones listed", sizeof(error->description));
+        }
+        error->count++;
+        error->total++;
+    }
+
+    // Copies out every error that happened again since the last call and starts its count over
+    int CTRE_ReadErrors(CTRE_Error* out, int max) {
+        std::lock_guard<std::mutex> lock(errors::mutex);
+        int n = 0;
+        for (int i = 0; i < errors::capacity && n < max; i++) {
+            if (errors::table[i].count > 0) {
+                out[n++] = errors::table[i];
+                errors::table[i].count = 0;
+            }
+        }
+        return n;
+    }
+}
@@ -0,0 +1,36 @@
+package phoenix
+
+// #include "errors.h"
+import "C"
+
+// Code of the Error that counts every kind of error and warning beyond the ones ReadErrors tells apart
+const OtherErrors = C.CTRE_OTHER_ERRORS
+
+// A kind of Phoenix error or warning, told apart by its code and where it was reported
+type Error struct {
+	Code             int // Negative for errors, positive for warnings
+	Device, Function string
+	Description      string
+	Count            uint64 // Since the last ReadErrors
+	Total            uint64
+}
+
+// Errors Phoenix reported since the last call, in place of the library printing each one and sending it to the
+// driver station. Every kind is returned once, with how many times it happened
+func ReadErrors() []Error {
+	var buffer [64]C.CTRE_Error
+	n := int(C.CTRE_ReadErrors(&buffer[0], C.int(len(buffer))))
+	errors := make([]Error, n)
+	for i := range errors {
+		entry := &buffer[i]
+		errors[i] = Error{
+			Code:        int(entry.code),
+			Device:      C.GoString(&entry.device[0]),
+			Function:    C.GoString(&entry.function[0]),
+			Description: C.GoString(&entry.description[0]),
+			Count:       uint64(entry.count),
+			Total:       uint64(entry.total),
+		}
+	}
+	return errors
+}
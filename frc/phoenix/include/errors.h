@@ -0,0 +1,25 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int32_t code;
+    char device[64], function[64], description[96];
+    uint64_t count; // Since the last CTRE_ReadErrors
+    uint64_t total;
+} CTRE_Error;
+
+// Code of the entry that counts every kind of error beyond the ones the table tells apart, far from any Phoenix code
+#define CTRE_OTHER_ERRORS INT32_MIN
+
+// describe fills in the description the first time an error is seen, it can be NULL
+void CTRE_RecordError(int32_t code, const char* device, const char* function,
+                      void (*describe)(int32_t code, char* description, size_t size));
+int CTRE_ReadErrors(CTRE_Error* errors, int max);
+
+#ifdef __cplusplus
+}
+#endif
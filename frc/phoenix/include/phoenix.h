@@ -1,4 +1,5 @@
 typedef void CTalon;
+typedef void CPigeon;
 
 #ifdef __cplusplus
 extern "C" {
@@ -10,6 +11,24 @@ void CTRE_Set(CTalon* talon, double output);
 
 void CTRE_Follow(CTalon* master, CTalon* slave);
 
+double CTRE_GetSensorPosition(CTalon* talon);
+
+double CTRE_GetSensorVelocity(CTalon* talon);
+
+double CTRE_GetMotorOutputPercent(CTalon* talon);
+
+// Sets every Talon to its mode and value in one call, modes are ctre::ControlMode values
+void CTRE_SetMany(CTalon* const* talons, const int* modes, const double* values, int count);
+
+void CTRE_GetSensorPositions(CTalon* const* talons, double* positions, int count);
+
+// Gains of the closed loop in slot 0
+void CTRE_ConfigPID(CTalon* talon, double kP, double kI, double kD, double kF);
+
+CPigeon* CTRE_CreatePigeon(int port);
+
+double CTRE_GetYaw(CPigeon* pigeon);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,11 @@
+#include "phoenix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+double CTRE_SimGetOutput(CTalon* talon);
+
+#ifdef __cplusplus
+}
+#endif
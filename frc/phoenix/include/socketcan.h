@@ -0,0 +1,18 @@
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint64_t framesSent, framesReceived;
+    uint64_t sendCalls, receiveCalls;
+    uint64_t sendErrors, overruns;
+} CTRE_CANStats;
+
+int32_t CTRE_SetCANInterface(const char* name);
+void CTRE_GetCANStats(CTRE_CANStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
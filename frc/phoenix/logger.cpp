@@ -0,0 +1,47 @@
+//go:build !sim || socketcan
+// +build !sim socketcan
+
+#include <cstring>
+#include <string>
+
+#include "ctre/phoenix/ErrorCode.h"
+#include "errors.h"
+
+namespace ctre {
+    // From the Phoenix CCI library, its error strings are linked on their own
+    void GetErrorDescription(ctre::phoenix::ErrorCode code, std::string& shortDescription,
+                             std::string& longDescription);
+}
+
+// Every Phoenix error goes through this class, whose library version prints a stack trace and sends the error to
+// the driver station. Defining it here keeps that version out of the link, so a failing device costs a lookup in
+// the error table per call instead of console and network traffic. The Go side reads the table into the data log
+class LoggerDriver {
+public:
+    static LoggerDriver* GetInstance();
+    ctre::phoenix::ErrorCode Log(ctre::phoenix::ErrorCode code, const char* device, const char* func, int hierarchy,
+                                 const char* stacktrace);
+};
+
+namespace {
+    LoggerDriver instance;
+
+    void describe(int32_t code, char* description, size_t size) {
+        std::string shortDescription, longDescription;
+        ctre::GetErrorDescription((ctre::phoenix::ErrorCode) code, shortDescription, longDescription);
+        strncpy(description, shortDescription.c_str(), size - 1);
+        description[size - 1] = 0;
+    }
+}
+
+LoggerDriver* LoggerDriver::GetInstance() {
+    return &instance;
+}
+
+ctre::phoenix::ErrorCode LoggerDriver::Log(ctre::phoenix::ErrorCode code, const char* device, const char* func,
+                                           int hierarchy, const char* stacktrace) {
+    if (code != ctre::phoenix::OKAY) {
+        CTRE_RecordError(code, device, func, describe);
+    }
+    return code;
+}
@@ -1,24 +1,85 @@
+//go:build !sim || socketcan
+// +build !sim socketcan
+
 #include "phoenix.h"
+#include "trace.h"
 
 #include "ctre/phoenix/motorcontrol/can/TalonSRX.h"
+#include "ctre/phoenix/sensors/PigeonIMU.h"
 
 #define TALON(ctalon) ((ctre::TalonSRX*) ctalon)
+#define PIGEON(cpigeon) ((ctre::PigeonIMU*) cpigeon)
 
 namespace ctre {
     using ctre::phoenix::motorcontrol::ControlMode;
     using ctre::phoenix::motorcontrol::can::TalonSRX;
+    using ctre::phoenix::sensors::PigeonIMU;
 }
 
+extern std::atomic<TraceHook> CTRE_traceHook;
+
 extern "C" {
     CTalon* CTRE_CreateTalon(int port) {
+        TraceScope scope(CTRE_traceHook, "CTRE_CreateTalon");
         return (CTalon*) new ctre::TalonSRX(port);
     }
 
     void CTRE_Set(CTalon* talon, double output) {
+        TraceScope scope(CTRE_traceHook, "CTRE_Set");
         TALON(talon)->Set(ctre::ControlMode::PercentOutput, output);
     }
 
     void CTRE_Follow(CTalon* master, CTalon* slave) {
+        TraceScope scope(CTRE_traceHook, "CTRE_Follow");
         TALON(slave)->Follow(*(TALON(master)));
     }
+
+    double CTRE_GetSensorPosition(CTalon* talon) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetSensorPosition");
+        return TALON(talon)->GetSelectedSensorPosition(0);
+    }
+
+    double CTRE_GetSensorVelocity(CTalon* talon) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetSensorVelocity");
+        return TALON(talon)->GetSelectedSensorVelocity(0);
+    }
+
+    double CTRE_GetMotorOutputPercent(CTalon* talon) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetMotorOutputPercent");
+        return TALON(talon)->GetMotorOutputPercent();
+    }
+
+    void CTRE_SetMany(CTalon* const* talons, const int* modes, const double* values, int count) {
+        TraceScope scope(CTRE_traceHook, "CTRE_SetMany");
+        for (int i = 0; i < count; i++) {
+            TALON(talons[i])->Set((ctre::ControlMode) modes[i], values[i]);
+        }
+    }
+
+    void CTRE_GetSensorPositions(CTalon* const* talons, double* positions, int count) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetSensorPositions");
+        for (int i = 0; i < count; i++) {
+            positions[i] = TALON(talons[i])->GetSelectedSensorPosition(0);
+        }
+    }
+
+    void CTRE_ConfigPID(CTalon* talon, double kP, double kI, double kD, double kF) {
+        TraceScope scope(CTRE_traceHook, "CTRE_ConfigPID");
+        TALON(talon)->Config_kP(0, kP);
+        TALON(talon)->Config_kI(0, kI);
+        TALON(talon)->Config_kD(0, kD);
+        TALON(talon)->Config_kF(0, kF);
+    }
+
+    CPigeon* CTRE_CreatePigeon(int port) {
+        TraceScope scope(CTRE_traceHook, "CTRE_CreatePigeon");
+        return (CPigeon*) new ctre::PigeonIMU(port);
+    }
+
+    double CTRE_GetYaw(CPigeon* pigeon) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetYaw");
+        double ypr[3] = {0, 0, 0};
+        PIGEON(pigeon)->GetYawPitchRoll(ypr);
+        return ypr[0];
+    }
 }
@@ -0,0 +1,179 @@
+//go:build sim && !socketcan
+// +build sim,!socketcan
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "simcan.h"
+#include "simdevice.h"
+#include "phoenix_sim.h"
+#include "trace.h"
+
+#define PERCENT_OUTPUT_MODE 0
+#define POSITION_MODE 1
+#define FOLLOWER_MODE 5
+
+// Frame IDs before the device number is added
+#define CONTROL_FRAME 0x02040080  // Demand and mode
+#define FEEDBACK_FRAME 0x02041440 // Selected sensor position and velocity
+
+// Stand-in for the Talon SRX on the desktop. Its state lives in a HAL sim device named "Talon SRX[port]"
+// so physics models can read the output and write the sensor without knowing about the bridge
+namespace sim {
+    struct Talon {
+        int port;
+        HAL_SimDeviceHandle device;
+        HAL_SimValueHandle output, position, velocity;
+        Talon* master;
+        std::vector<Talon*> followers;
+        double kP, kF;
+    };
+
+    void setOutput(Talon* talon, double output) {
+        SimSetDouble(talon->output, output);
+        for (Talon* follower : talon->followers) {
+            setOutput(follower, output);
+        }
+    }
+
+    // Demand in 24 signed bits big endian, percent output in 1023rds like the Talon's own resolution, then the mode
+    void sendControl(Talon* talon, int mode, double demand) {
+        double scaled = std::round(mode == PERCENT_OUTPUT_MODE ? demand * 1023 : demand);
+        int32_t value = (int32_t) (scaled > 0x7FFFFF ? 0x7FFFFF : scaled < -0x800000 ? -0x800000 : scaled);
+        uint8_t data[8] = {(uint8_t) (value >> 16), (uint8_t) (value >> 8), (uint8_t) value, (uint8_t) mode};
+        SimSendFrame(CONTROL_FRAME | talon->port, data, sizeof(data));
+    }
+
+    // Position in 24 signed bits and velocity in 16, both big endian
+    void receiveFeedback(Talon* talon) {
+        uint8_t data[8];
+        if (SimReceiveFrame(FEEDBACK_FRAME | talon->port, data)) {
+            int32_t position = (int32_t) ((uint32_t) data[0] << 24 | (uint32_t) data[1] << 16 | (uint32_t) data[2] << 8) >> 8;
+            SimSetDouble(talon->position, position);
+            SimSetDouble(talon->velocity, (int16_t) (data[3] << 8 | data[4]));
+        }
+    }
+
+    void unfollow(Talon* talon) {
+        if (talon->master) {
+            std::vector<Talon*>& siblings = talon->master->followers;
+            for (auto it = siblings.begin(); it != siblings.end(); ++it) {
+                if (*it == talon) {
+                    siblings.erase(it);
+                    break;
+                }
+            }
+            talon->master = nullptr;
+        }
+    }
+
+    // A Talon closes its loop every millisecond, the stand-in only each time it is set and only with kP and kF
+    double closedLoop(Talon* talon, int mode, double demand) {
+        receiveFeedback(talon);
+        double sensor = SimGetDouble(mode == POSITION_MODE ? talon->position : talon->velocity);
+        double output = (talon->kF * demand + talon->kP * (demand - sensor)) / 1023;
+        return output > 1 ? 1 : output < -1 ? -1 : output;
+    }
+
+    struct Pigeon {
+        HAL_SimDeviceHandle device;
+        HAL_SimValueHandle yaw;
+    };
+}
+
+#define TALON(ctalon) ((sim::Talon*) ctalon)
+#define PIGEON(cpigeon) ((sim::Pigeon*) cpigeon)
+
+extern std::atomic<TraceHook> CTRE_traceHook;
+
+extern "C" {
+    CTalon* CTRE_CreateTalon(int port) {
+        TraceScope scope(CTRE_traceHook, "CTRE_CreateTalon");
+        std::string name = "Talon SRX[" + std::to_string(port) + "]";
+        auto talon = new sim::Talon{port, HAL_CreateSimDevice(name.c_str())};
+        talon->output = SimCreateDouble(talon->device, "Output", true, 0.0);
+        talon->position = SimCreateDouble(talon->device, "Position", false, 0.0);
+        talon->velocity = SimCreateDouble(talon->device, "Velocity", false, 0.0);
+        return (CTalon*) talon;
+    }
+
+    void CTRE_Set(CTalon* talon, double output) {
+        TraceScope scope(CTRE_traceHook, "CTRE_Set");
+        sim::unfollow(TALON(talon));
+        sim::sendControl(TALON(talon), PERCENT_OUTPUT_MODE, output);
+        sim::setOutput(TALON(talon), output);
+    }
+
+    void CTRE_Follow(CTalon* master, CTalon* slave) {
+        TraceScope scope(CTRE_traceHook, "CTRE_Follow");
+        sim::unfollow(TALON(slave));
+        TALON(slave)->master = TALON(master);
+        TALON(master)->followers.push_back(TALON(slave));
+        sim::sendControl(TALON(slave), FOLLOWER_MODE, TALON(master)->port);
+        sim::setOutput(TALON(slave), SimGetDouble(TALON(master)->output));
+    }
+
+    double CTRE_GetSensorPosition(CTalon* talon) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetSensorPosition");
+        sim::receiveFeedback(TALON(talon));
+        return SimGetDouble(TALON(talon)->position);
+    }
+
+    double CTRE_GetSensorVelocity(CTalon* talon) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetSensorVelocity");
+        sim::receiveFeedback(TALON(talon));
+        return SimGetDouble(TALON(talon)->velocity);
+    }
+
+    double CTRE_GetMotorOutputPercent(CTalon* talon) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetMotorOutputPercent");
+        return SimGetDouble(TALON(talon)->output);
+    }
+
+    void CTRE_SetMany(CTalon* const* talons, const int* modes, const double* values, int count) {
+        TraceScope scope(CTRE_traceHook, "CTRE_SetMany");
+        for (int i = 0; i < count; i++) {
+            sim::Talon* talon = TALON(talons[i]);
+            sim::unfollow(talon);
+            sim::sendControl(talon, modes[i], values[i]);
+            double output = values[i];
+            if (modes[i] != PERCENT_OUTPUT_MODE) {
+                output = sim::closedLoop(talon, modes[i], values[i]);
+            }
+            sim::setOutput(talon, output);
+        }
+    }
+
+    void CTRE_GetSensorPositions(CTalon* const* talons, double* positions, int count) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetSensorPositions");
+        for (int i = 0; i < count; i++) {
+            sim::receiveFeedback(TALON(talons[i]));
+            positions[i] = SimGetDouble(TALON(talons[i])->position);
+        }
+    }
+
+    void CTRE_ConfigPID(CTalon* talon, double kP, double kI, double kD, double kF) {
+        TraceScope scope(CTRE_traceHook, "CTRE_ConfigPID");
+        TALON(talon)->kP = kP;
+        TALON(talon)->kF = kF;
+    }
+
+    // The yaw is in degrees, written by whichever model turns the robot
+    CPigeon* CTRE_CreatePigeon(int port) {
+        TraceScope scope(CTRE_traceHook, "CTRE_CreatePigeon");
+        std::string name = "Pigeon IMU[" + std::to_string(port) + "]";
+        auto pigeon = new sim::Pigeon{HAL_CreateSimDevice(name.c_str())};
+        pigeon->yaw = SimCreateDouble(pigeon->device, "Yaw", false, 0.0);
+        return (CPigeon*) pigeon;
+    }
+
+    double CTRE_GetYaw(CPigeon* pigeon) {
+        TraceScope scope(CTRE_traceHook, "CTRE_GetYaw");
+        return SimGetDouble(PIGEON(pigeon)->yaw);
+    }
+
+    double CTRE_SimGetOutput(CTalon* talon) {
+        return SimGetDouble(TALON(talon)->output);
+    }
+}
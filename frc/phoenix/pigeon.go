@@ -0,0 +1,19 @@
+package phoenix
+
+// #include "phoenix.h"
+import "C"
+import "unsafe"
+
+// Pigeon IMU on the CAN bus, used as the drive's gyro
+type Pigeon struct {
+	handle unsafe.Pointer
+}
+
+func NewPigeon(port int) *Pigeon {
+	return &Pigeon{handle: C.CTRE_CreatePigeon(C.int(port))}
+}
+
+// Degrees counter clockwise, counting every turn since the Pigeon started rather than wrapping
+func (pigeon *Pigeon) Yaw() float64 {
+	return float64(C.CTRE_GetYaw(pigeon.handle))
+}
@@ -0,0 +1,495 @@
+//go:build sim && socketcan
+// +build sim,socketcan
+
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ctre/phoenix/ErrorCode.h"
+#include "ctre/phoenix/platform/Platform.h"
+#include "socketcan.h"
+#include "trace.h"
+
+// Phoenix platform layer over Linux SocketCAN so the real Phoenix stack can run on a desktop against a vcan
+// interface. Frames are moved in batches with recvmmsg/sendmmsg by one receive and one transmit thread, and the
+// mid level API (latest frame per ID, periodic sends, stream sessions) is served from memory
+extern std::atomic<TraceHook> CTRE_traceHook;
+
+namespace socketcan {
+    using ctre::phoenix::platform::can::canframe_t;
+    using Clock = std::chrono::steady_clock;
+
+    const int batchSize = 32;
+    const size_t rawCapacity = 1024;
+
+    // Same flag the HAL uses for 11 bit IDs, everything else is sent as 29 bit
+    const uint32_t standardFrame = 0x40000000;
+
+    struct Periodic {
+        can_frame frame;
+        Clock::duration period;
+        Clock::time_point next;
+    };
+
+    struct Latest {
+        canframe_t frame;
+        bool fresh;
+    };
+
+    struct Session {
+        uint32_t id, mask;
+        size_t capacity;
+        std::deque<canframe_t> frames;
+    };
+
+    struct Bus {
+        std::mutex mutex;
+        std::condition_variable received, transmit;
+        std::string name = "can0";
+        int fd = -1;
+        bool running = false;
+        std::thread receiver, transmitter;
+
+        std::vector<can_frame> queue;
+        std::map<uint32_t, Periodic> periodic;
+        std::map<uint32_t, Latest> latest;
+        std::deque<canframe_t> raw;
+        std::map<uint32_t, Session> sessions;
+        uint32_t nextSession = 1;
+
+        CTRE_CANStats stats = {};
+    };
+
+    Bus bus;
+
+    uint32_t timestamp() {
+        using namespace std::chrono;
+        return (uint32_t) duration_cast<microseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    can_frame toSocketCAN(uint32_t messageID, const uint8_t* data, uint8_t dataSize) {
+        can_frame frame = {};
+        if (messageID & standardFrame) {
+            frame.can_id = messageID & CAN_SFF_MASK;
+        } else {
+            frame.can_id = (messageID & CAN_EFF_MASK) | CAN_EFF_FLAG;
+        }
+        frame.can_dlc = dataSize > 8 ? 8 : dataSize;
+        if (data) {
+            memcpy(frame.data, data, frame.can_dlc);
+        }
+        return frame;
+    }
+
+    canframe_t fromSocketCAN(const can_frame& frame, uint32_t time) {
+        canframe_t event = {};
+        if (frame.can_id & CAN_EFF_FLAG) {
+            event.arbID = frame.can_id & CAN_EFF_MASK;
+        } else {
+            event.arbID = (frame.can_id & CAN_SFF_MASK) | standardFrame;
+            event.flags = 1;
+        }
+        event.timeStampUs = time;
+        event.dlc = frame.can_dlc > 8 ? 8 : frame.can_dlc;
+        memcpy(event.data, frame.data, event.dlc);
+        return event;
+    }
+
+    // Called with the lock held for every frame in a received batch
+    void dispatch(const canframe_t& frame) {
+        bus.latest[frame.arbID] = Latest{frame, true};
+        for (auto& entry : bus.sessions) {
+            Session& session = entry.second;
+            if ((frame.arbID & session.mask) == (session.id & session.mask)) {
+                if (session.frames.size() == session.capacity) {
+                    session.frames.pop_front();
+                    bus.stats.overruns++;
+                }
+                session.frames.push_back(frame);
+            }
+        }
+        if (bus.raw.size() == rawCapacity) {
+            bus.raw.pop_front();
+            bus.stats.overruns++;
+        }
+        bus.raw.push_back(frame);
+    }
+
+    void receive(int fd) {
+        can_frame frames[batchSize];
+        iovec vectors[batchSize];
+        mmsghdr messages[batchSize];
+        for (int i = 0; i < batchSize; i++) {
+            vectors[i] = iovec{&frames[i], sizeof(can_frame)};
+            messages[i] = {};
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        pollfd poller = {fd, POLLIN, 0};
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(bus.mutex);
+                if (!bus.running) {
+                    return;
+                }
+            }
+            if (poll(&poller, 1, 100) <= 0) {
+                continue;
+            }
+            int count = recvmmsg(fd, messages, batchSize, MSG_DONTWAIT, nullptr);
+            if (count <= 0) {
+                continue;
+            }
+            TraceScope scope(CTRE_traceHook, "CAN receive");
+            uint32_t time = timestamp();
+            std::lock_guard<std::mutex> lock(bus.mutex);
+            bus.stats.receiveCalls++;
+            bus.stats.framesReceived += count;
+            for (int i = 0; i < count; i++) {
+                dispatch(fromSocketCAN(frames[i], time));
+            }
+            bus.received.notify_all();
+        }
+    }
+
+    // Sends everything queued or due in as few sendmmsg calls as possible, then sleeps until the next periodic frame
+    void transmit(int fd) {
+        std::vector<can_frame> batch;
+        std::vector<iovec> vectors;
+        std::vector<mmsghdr> messages;
+
+        std::unique_lock<std::mutex> lock(bus.mutex);
+        while (bus.running) {
+            Clock::time_point now = Clock::now();
+            Clock::time_point wake = now + std::chrono::milliseconds(100);
+            batch.swap(bus.queue);
+            for (auto& entry : bus.periodic) {
+                Periodic& periodic = entry.second;
+                if (periodic.next <= now) {
+                    batch.push_back(periodic.frame);
+                    periodic.next += periodic.period;
+                    if (periodic.next <= now) {
+                        periodic.next = now + periodic.period;
+                    }
+                }
+                if (periodic.next < wake) {
+                    wake = periodic.next;
+                }
+            }
+
+            if (!batch.empty()) {
+                TraceScope scope(CTRE_traceHook, "CAN transmit");
+                lock.unlock();
+                vectors.resize(batch.size());
+                messages.resize(batch.size());
+                for (size_t i = 0; i < batch.size(); i++) {
+                    vectors[i] = iovec{&batch[i], sizeof(can_frame)};
+                    messages[i] = {};
+                    messages[i].msg_hdr.msg_iov = &vectors[i];
+                    messages[i].msg_hdr.msg_iovlen = 1;
+                }
+                size_t sent = 0, calls = 0;
+                while (sent < batch.size()) {
+                    int count = sendmmsg(fd, &messages[sent], batch.size() - sent, 0);
+                    calls++;
+                    if (count <= 0) {
+                        break;
+                    }
+                    sent += count;
+                }
+                lock.lock();
+                bus.stats.sendCalls += calls;
+                bus.stats.framesSent += sent;
+                bus.stats.sendErrors += batch.size() - sent;
+                batch.clear();
+                continue;
+            }
+            if (bus.queue.empty()) {
+                bus.transmit.wait_until(lock, wake);
+            }
+        }
+    }
+
+    int32_t start(const char* name) {
+        int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+        if (fd < 0) {
+            return ctre::phoenix::GeneralError;
+        }
+        sockaddr_can address = {};
+        address.can_family = AF_CAN;
+        address.can_ifindex = if_nametoindex(name);
+        if (address.can_ifindex == 0 || bind(fd, (sockaddr*) &address, sizeof(address)) < 0) {
+            close(fd);
+            return ctre::phoenix::InvalidParamValue;
+        }
+        int buffer = 1 << 20;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+
+        std::lock_guard<std::mutex> lock(bus.mutex);
+        if (bus.running) {
+            // Another thread opened the bus first
+            close(fd);
+            return ctre::phoenix::OK;
+        }
+        bus.name = name;
+        bus.fd = fd;
+        bus.running = true;
+        bus.receiver = std::thread(receive, fd);
+        bus.transmitter = std::thread(transmit, fd);
+        // Names for top and for traces, at most 15 characters
+        pthread_setname_np(bus.receiver.native_handle(), "can receive");
+        pthread_setname_np(bus.transmitter.native_handle(), "can transmit");
+        return ctre::phoenix::OK;
+    }
+
+    void stop() {
+        int fd;
+        {
+            std::lock_guard<std::mutex> lock(bus.mutex);
+            if (!bus.running) {
+                return;
+            }
+            bus.running = false;
+            fd = bus.fd;
+            bus.fd = -1;
+            bus.transmit.notify_all();
+            bus.received.notify_all();
+        }
+        bus.receiver.join();
+        bus.transmitter.join();
+        close(fd);
+
+        std::lock_guard<std::mutex> lock(bus.mutex);
+        bus.queue.clear();
+        bus.periodic.clear();
+        bus.latest.clear();
+        bus.raw.clear();
+        bus.sessions.clear();
+    }
+
+    // Phoenix starts talking before anyone picks an interface, so the default one is opened on first use
+    bool ensureOpen() {
+        {
+            std::lock_guard<std::mutex> lock(bus.mutex);
+            if (bus.running) {
+                return true;
+            }
+        }
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lock(bus.mutex);
+            name = bus.name;
+        }
+        return start(name.c_str()) == ctre::phoenix::OK;
+    }
+
+    void send(const can_frame& frame) {
+        std::lock_guard<std::mutex> lock(bus.mutex);
+        bus.queue.push_back(frame);
+        bus.transmit.notify_one();
+    }
+}
+
+namespace ctre {
+namespace phoenix {
+namespace platform {
+namespace can {
+    int32_t SetCANInterface(const char* CANInterface) {
+        socketcan::stop();
+        return socketcan::start(CANInterface);
+    }
+
+    void CANbus_GetStatus(float* busUtilPerc, uint32_t* busOffCount, uint32_t* txFullCount, uint32_t* rec,
+                          uint32_t* tec, int32_t* status) {
+        std::lock_guard<std::mutex> lock(socketcan::bus.mutex);
+        *busUtilPerc = 0;
+        *busOffCount = 0;
+        *txFullCount = (uint32_t) socketcan::bus.stats.sendErrors;
+        *rec = 0;
+        *tec = 0;
+        *status = socketcan::bus.running ? OK : GeneralError;
+    }
+
+    int32_t CANbus_SendFrame(uint32_t messageID, const uint8_t* data, uint8_t dataSize) {
+        if (!socketcan::ensureOpen()) {
+            return TxFailed;
+        }
+        socketcan::send(socketcan::toSocketCAN(messageID, data, dataSize));
+        return OK;
+    }
+
+    int32_t CANbus_ReceiveFrame(canframe_t* toFill, uint32_t frameCap, uint32_t* numFilled) {
+        *numFilled = 0;
+        if (!socketcan::ensureOpen()) {
+            return RxTimeout;
+        }
+        std::unique_lock<std::mutex> lock(socketcan::bus.mutex);
+        socketcan::bus.received.wait_for(lock, std::chrono::milliseconds(100), [] {
+            return !socketcan::bus.raw.empty() || !socketcan::bus.running;
+        });
+        auto& raw = socketcan::bus.raw;
+        while (*numFilled < frameCap && !raw.empty()) {
+            toFill[(*numFilled)++] = raw.front();
+            raw.pop_front();
+        }
+        return *numFilled ? OK : RxTimeout;
+    }
+
+    void CANComm_SendMessage(uint32_t messageID, const uint8_t* data, uint8_t dataSize, int32_t periodMs,
+                             int32_t* status) {
+        if (!socketcan::ensureOpen()) {
+            *status = TxFailed;
+            return;
+        }
+        can_frame frame = socketcan::toSocketCAN(messageID, data, dataSize);
+        std::lock_guard<std::mutex> lock(socketcan::bus.mutex);
+        if (periodMs > 0) {
+            // The first repeat is due immediately so the frame also goes out now
+            auto period = std::chrono::milliseconds(periodMs);
+            socketcan::bus.periodic[messageID] = socketcan::Periodic{frame, period, socketcan::Clock::now()};
+        } else {
+            // A negative period stops a repeating frame without sending it again
+            socketcan::bus.periodic.erase(messageID);
+            if (periodMs == 0) {
+                socketcan::bus.queue.push_back(frame);
+            }
+        }
+        socketcan::bus.transmit.notify_one();
+        *status = OK;
+    }
+
+    void CANComm_ReceiveMessage(uint32_t* messageID, uint32_t messageIDMask, uint8_t* data, uint8_t* dataSize,
+                                uint32_t* timeStamp, int32_t* status) {
+        if (!socketcan::ensureOpen()) {
+            *status = CAN_MSG_NOT_FOUND;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(socketcan::bus.mutex);
+        for (auto& entry : socketcan::bus.latest) {
+            if ((entry.first & messageIDMask) == (*messageID & messageIDMask)) {
+                socketcan::Latest& latest = entry.second;
+                *messageID = latest.frame.arbID;
+                *dataSize = latest.frame.dlc;
+                memcpy(data, latest.frame.data, latest.frame.dlc);
+                *timeStamp = latest.frame.timeStampUs / 1000;
+                *status = latest.fresh ? OK : CAN_MSG_STALE;
+                latest.fresh = false;
+                return;
+            }
+        }
+        *status = CAN_MSG_NOT_FOUND;
+    }
+
+    void CANComm_OpenStreamSession(uint32_t* sessionHandle, uint32_t messageID, uint32_t messageIDMask,
+                                   uint32_t maxMessages, int32_t* status) {
+        if (!socketcan::ensureOpen()) {
+            *status = CAN_NO_SESSIONS_AVAIL;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(socketcan::bus.mutex);
+        *sessionHandle = socketcan::bus.nextSession++;
+        socketcan::bus.sessions[*sessionHandle] = socketcan::Session{messageID, messageIDMask, maxMessages ? maxMessages : 1};
+        *status = OK;
+    }
+
+    void CANComm_CloseStreamSession(uint32_t sessionHandle) {
+        std::lock_guard<std::mutex> lock(socketcan::bus.mutex);
+        socketcan::bus.sessions.erase(sessionHandle);
+    }
+
+    void CANComm_ReadStreamSession(uint32_t sessionHandle, canframe_t* messages, uint32_t messagesToRead,
+                                   uint32_t* messagesRead, int32_t* status) {
+        std::lock_guard<std::mutex> lock(socketcan::bus.mutex);
+        *messagesRead = 0;
+        auto it = socketcan::bus.sessions.find(sessionHandle);
+        if (it == socketcan::bus.sessions.end()) {
+            *status = CAN_INVALID_PARAM;
+            return;
+        }
+        auto& frames = it->second.frames;
+        while (*messagesRead < messagesToRead && !frames.empty()) {
+            messages[(*messagesRead)++] = frames.front();
+            frames.pop_front();
+        }
+        *status = OK;
+    }
+
+    int32_t CANComm_GetTxSchedulerStatus(void* unusedControlWorld) {
+        return 0;
+    }
+} // namespace can
+
+    void SleepUs(int timeUs) {
+        std::this_thread::sleep_for(std::chrono::microseconds(timeUs));
+    }
+
+    std::string GetStackTrace(int offset) {
+        return "";
+    }
+
+    void ReportError(int isError, int32_t errorCode, int isLVCode, const char* details, const char* location,
+                     const char* callStack) {
+        fprintf(stderr, "%s %d: %s %s\n", isError ? "Error" : "Warning", errorCode, details, location);
+    }
+
+    // There are no simulated devices behind a real bus
+    int32_t SimCreate(DeviceType type, int id) {
+        return OK;
+    }
+
+    int32_t SimConfigGet(DeviceType type, uint32_t param, uint32_t valueToSend, uint32_t& outValueReceived,
+                         uint32_t& outSubvalue, uint32_t ordinal, uint32_t id) {
+        return OK;
+    }
+
+    int32_t SimConfigSet(DeviceType type, uint32_t param, uint32_t value, uint32_t subValue, uint32_t ordinal,
+                         uint32_t id) {
+        return OK;
+    }
+
+    int32_t SimDestroy(DeviceType type, int id) {
+        return OK;
+    }
+
+    int32_t SimDestroyAll() {
+        return OK;
+    }
+
+    int32_t DisposePlatform() {
+        socketcan::stop();
+        return OK;
+    }
+
+    int32_t StartPlatform() {
+        return socketcan::ensureOpen() ? OK : GeneralError;
+    }
+} // namespace platform
+} // namespace phoenix
+} // namespace ctre
+
+extern "C" {
+    int32_t CTRE_SetCANInterface(const char* name) {
+        return ctre::phoenix::platform::can::SetCANInterface(name);
+    }
+
+    void CTRE_GetCANStats(CTRE_CANStats* stats) {
+        std::lock_guard<std::mutex> lock(socketcan::bus.mutex);
+        *stats = socketcan::bus.stats;
+    }
+}
@@ -1,8 +1,7 @@
 package phoenix
 
-// #cgo CFLAGS: -I${SRCDIR}/include
-// #cgo CXXFLAGS: -I${SRCDIR}/include
-// #cgo LDFLAGS: -L${SRCDIR}/../lib/athena -lwpiHal -lwpiutil -lstdc++ -lm -lFRC_NetworkCommunication -lNiFpga -lNiFpgaLv -lniriodevenum -lniriosession -lNiRioSrv -lRoboRIO_FRC_ChipObject -lvisa -Llib/athena -lCTRE_Phoenix -lCTRE_PhoenixCCI
+// #cgo CFLAGS: -I${SRCDIR}/include -I${SRCDIR}/../include
+// #cgo CXXFLAGS: -I${SRCDIR}/include -I${SRCDIR}/../include
 // #include "phoenix.h"
 import "C"
 import "unsafe"
@@ -10,10 +9,12 @@ import "unsafe"
 type Talon struct {
 	port   int
 	handle unsafe.Pointer
+	mode   ControlMode
+	output float64
 }
 
 func NewTalon(port int) *Talon {
-	return &Talon{port, C.CTRE_CreateTalon(C.int(port))}
+	return &Talon{port: port, handle: C.CTRE_CreateTalon(C.int(port))}
 }
 
 func NewSlaveTalon(port int, talon *Talon) *Talon {
@@ -23,6 +24,35 @@ func NewSlaveTalon(port int, talon *Talon) *Talon {
 }
 
 func (talon *Talon) Set(output float64) {
+	talon.mode, talon.output = PercentOutput, output
 	C.CTRE_Set(talon.handle, C.double(output))
 }
 
+// Last value given to Set or a batch, in the units of Mode, without asking the Talon
+func (talon *Talon) Output() float64 {
+	return talon.output
+}
+
+func (talon *Talon) Mode() ControlMode {
+	return talon.mode
+}
+
+// Fraction of full power the Talon is applying whatever its mode, asked of the Talon
+func (talon *Talon) AppliedOutput() float64 {
+	return float64(C.CTRE_GetMotorOutputPercent(talon.handle))
+}
+
+// Native units, encoder ticks
+func (talon *Talon) GetSensorPosition() float64 {
+	return float64(C.CTRE_GetSensorPosition(talon.handle))
+}
+
+// Native units, encoder ticks per 100 ms
+func (talon *Talon) GetSensorVelocity() float64 {
+	return float64(C.CTRE_GetSensorVelocity(talon.handle))
+}
+
+// Gains of the Talon's own closed loop, in its native units where an output of 1023 is full power
+func (talon *Talon) ConfigPID(kP, kI, kD, kF float64) {
+	C.CTRE_ConfigPID(talon.handle, C.double(kP), C.double(kI), C.double(kD), C.double(kF))
+}
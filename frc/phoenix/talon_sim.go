@@ -0,0 +1,24 @@
+//go:build sim && !socketcan
+// +build sim,!socketcan
+
+package phoenix
+
+// #cgo CXXFLAGS: -I${SRCDIR}/../include -I${SRCDIR}/../halsim/include
+// #include <stdlib.h>
+// #include "errors.h"
+// #include "phoenix_sim.h"
+import "C"
+import "unsafe"
+
+// Output the Talon is applying, resolved through the Talon it follows
+func (talon *Talon) SimOutput() float64 {
+	return float64(C.CTRE_SimGetOutput(talon.handle))
+}
+
+// Counts an error as if Phoenix had reported it, to see what the robot code and the log do with a failing device
+func SimReportError(code int, device, function string) {
+	cdevice, cfunction := C.CString(device), C.CString(function)
+	defer C.free(unsafe.Pointer(cdevice))
+	defer C.free(unsafe.Pointer(cfunction))
+	C.CTRE_RecordError(C.int32_t(code), cdevice, cfunction, nil)
+}
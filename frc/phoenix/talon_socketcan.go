@@ -0,0 +1,44 @@
+//go:build sim && socketcan
+// +build sim,socketcan
+
+package phoenix
+
+// #cgo CXXFLAGS: -I${SRCDIR}/../include
+// #cgo LDFLAGS: -L${SRCDIR}/../lib/linuxx86-64 -lCTRE_Phoenix -lCTRE_PhoenixCanutil -lCTRE_PhoenixCCI -lstdc++ -lpthread
+// #include <stdlib.h>
+// #include "socketcan.h"
+import "C"
+import (
+	"fmt"
+	"unsafe"
+)
+
+// Counters of the SocketCAN platform, a batch is one sendmmsg or recvmmsg call
+type CANStats struct {
+	FramesSent, FramesReceived uint64
+	SendCalls, ReceiveCalls    uint64
+	SendErrors, Overruns       uint64
+}
+
+// Moves Phoenix to another SocketCAN interface such as "vcan0", "can0" is used until this is called
+func SetCANInterface(name string) error {
+	cname := C.CString(name)
+	defer C.free(unsafe.Pointer(cname))
+	if status := C.CTRE_SetCANInterface(cname); status != 0 {
+		return fmt.Errorf("phoenix: could not open CAN interface %s (%d)", name, status)
+	}
+	return nil
+}
+
+func GetCANStats() CANStats {
+	var stats C.CTRE_CANStats
+	C.CTRE_GetCANStats(&stats)
+	return CANStats{
+		FramesSent:     uint64(stats.framesSent),
+		FramesReceived: uint64(stats.framesReceived),
+		SendCalls:      uint64(stats.sendCalls),
+		ReceiveCalls:   uint64(stats.receiveCalls),
+		SendErrors:     uint64(stats.sendErrors),
+		Overruns:       uint64(stats.overruns),
+	}
+}
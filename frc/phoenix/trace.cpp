@@ -0,0 +1,7 @@
+#include "trace.h"
+
+std::atomic<TraceHook> CTRE_traceHook;
+
+extern "C" void CTRE_SetTraceHook(TraceHook hook) {
+    CTRE_traceHook.store(hook);
+}
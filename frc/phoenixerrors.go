@@ -0,0 +1,40 @@
+package frc
+
+import (
+	"fmt"
+	"go-frc/frc/phoenix"
+	"time"
+)
+
+// How often Phoenix errors are collected. Each kind of error is reported at most once per period, with its count
+var PhoenixErrorPeriod = time.Second
+
+// Writes Phoenix errors to the data log, or prints them when there is no log
+func reportPhoenixErrors() {
+	trace := traceName("phoenix errors")
+	for range time.Tick(PhoenixErrorPeriod) {
+		traceBegin(trace)
+		now := getFPGATime()
+		for _, reported := range phoenix.ReadErrors() {
+			kind := "error"
+			if reported.Code > 0 {
+				kind = "warning"
+			}
+			if reported.Description != "" {
+				kind += " (" + reported.Description + ")"
+			}
+			text := fmt.Sprintf("Phoenix %s %d in %s %s: %d times, %d in total", kind, reported.Code, reported.Device,
+				reported.Function, reported.Count, reported.Total)
+			if reported.Code == phoenix.OtherErrors {
+				text = fmt.Sprintf("Phoenix errors and warnings of other kinds: %d times, %d in total", reported.Count,
+					reported.Total)
+			}
+			if dataLog != nil {
+				dataLog.Event(now, text)
+			} else {
+				fmt.Println(text)
+			}
+		}
+		traceEnd(trace)
+	}
+}
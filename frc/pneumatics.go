@@ -0,0 +1,134 @@
+package frc
+
+// #include "hal.h"
+import "C"
+import (
+	"fmt"
+	"time"
+)
+
+const (
+	PCMChannels = 8
+)
+
+type CompressorStatus struct {
+	Running        bool
+	ClosedLoop     bool
+	PressureSwitch bool // True when the tank is full
+	Current        float64
+}
+
+// Solenoid state is tracked as a bitmask over the tick and written to the PCM with a single call,
+// so valves set in the same tick actuate together and an unchanged state costs no CAN traffic
+type PneumaticsModule struct {
+	module             int
+	desired, committed int32
+	hasCommitted       bool
+	oneShots           [PCMChannels]C.HAL_SolenoidHandle
+	compressor         C.HAL_CompressorHandle
+	errors             int
+}
+
+// One channel of a PneumaticsModule
+type Solenoid struct {
+	pcm     *PneumaticsModule
+	channel int
+}
+
+func NewPneumaticsModule(module int) *PneumaticsModule {
+	status := C.int32_t(0)
+	compressor := C.HAL_InitializeCompressor(C.int32_t(module), &status)
+	handleErrorStatus(status)
+	pcm := &PneumaticsModule{module: module, compressor: compressor}
+	onTickEnd(pcm.Commit)
+	return pcm
+}
+
+// Panics when the module has no such channel, rather than the write going nowhere
+func (pcm *PneumaticsModule) Solenoid(channel int) *Solenoid {
+	if channel < 0 || channel >= PCMChannels {
+		panic(fmt.Sprintf("PCM %d has no solenoid channel %d", pcm.module, channel))
+	}
+	return &Solenoid{pcm: pcm, channel: channel}
+}
+
+func (solenoid *Solenoid) Set(on bool) {
+	if on {
+		solenoid.pcm.desired |= 1 << uint(solenoid.channel)
+	} else {
+		solenoid.pcm.desired &^= 1 << uint(solenoid.channel)
+	}
+}
+
+// Desired state for this tick, which may not have been written yet
+func (solenoid *Solenoid) Get() bool {
+	return solenoid.pcm.desired&(1<<uint(solenoid.channel)) != 0
+}
+
+// Writes the desired state if it differs from the last write, called automatically at the end of each tick.
+// A failed write is counted instead of panicking, so a PCM missing from the bus does not stop the loop, and is
+// tried again next tick
+func (pcm *PneumaticsModule) Commit() {
+	if pcm.hasCommitted && pcm.desired == pcm.committed {
+		return
+	}
+	status := C.int32_t(0)
+	C.HAL_SetAllSolenoids(C.int32_t(pcm.module), C.int32_t(pcm.desired), &status)
+	if status != 0 {
+		pcm.errors++
+		return
+	}
+	pcm.committed, pcm.hasCommitted = pcm.desired, true
+}
+
+// Number of writes that failed
+func (pcm *PneumaticsModule) Errors() int {
+	return pcm.errors
+}
+
+// Reads back what the PCM is actually outputting, this is a CAN read so avoid it in the loop
+func (pcm *PneumaticsModule) ReadAll() int32 {
+	status := C.int32_t(0)
+	state := C.HAL_GetAllSolenoids(C.int32_t(pcm.module), &status)
+	handleErrorStatus(status)
+	return int32(state)
+}
+
+// Pulses a channel on for the duration using the PCM's own timer, so the loop does not have to turn it back off.
+// The solenoid should be left off with Set
+func (solenoid *Solenoid) FireOneShot(duration time.Duration) {
+	pcm := solenoid.pcm
+	status := C.int32_t(0)
+	handle := pcm.oneShots[solenoid.channel]
+	if handle == 0 {
+		port := C.HAL_GetPortWithModule(C.int32_t(pcm.module), C.int32_t(solenoid.channel))
+		handle = C.HAL_InitializeSolenoidPort(port, &status)
+		handleErrorStatus(status)
+		pcm.oneShots[solenoid.channel] = handle
+	}
+	C.HAL_SetOneShotDuration(handle, C.int32_t(duration/time.Millisecond), &status)
+	handleErrorStatus(status)
+	C.HAL_FireOneShot(handle, &status)
+	handleErrorStatus(status)
+}
+
+func (pcm *PneumaticsModule) SetClosedLoopControl(enabled bool) {
+	status := C.int32_t(0)
+	value := C.HAL_Bool(0)
+	if enabled {
+		value = 1
+	}
+	C.HAL_SetCompressorClosedLoopControl(pcm.compressor, value, &status)
+	handleErrorStatus(status)
+}
+
+func (pcm *PneumaticsModule) CompressorStatus() CompressorStatus {
+	status := C.int32_t(0)
+	var compressorStatus CompressorStatus
+	compressorStatus.Running = C.HAL_GetCompressor(pcm.compressor, &status) != 0
+	compressorStatus.ClosedLoop = C.HAL_GetCompressorClosedLoopControl(pcm.compressor, &status) != 0
+	compressorStatus.PressureSwitch = C.HAL_GetCompressorPressureSwitch(pcm.compressor, &status) != 0
+	compressorStatus.Current = float64(C.HAL_GetCompressorCurrent(pcm.compressor, &status))
+	handleErrorStatus(status)
+	return compressorStatus
+}
@@ -0,0 +1,115 @@
+package frc
+
+// #include "hal.h"
+//
+// // Both write every port even when one fails, and return how many failed
+// static int32_t setPWMSpeeds(const HAL_DigitalHandle* handles, const double* speeds, int32_t count) {
+//     int32_t failed = 0;
+//     for (int32_t i = 0; i < count; i++) {
+//         int32_t status = 0;
+//         HAL_SetPWMSpeed(handles[i], speeds[i], &status);
+//         failed += status != 0;
+//     }
+//     return failed;
+// }
+//
+// static int32_t disablePWMs(const HAL_DigitalHandle* handles, int32_t count) {
+//     int32_t failed = 0;
+//     for (int32_t i = 0; i < count; i++) {
+//         int32_t status = 0;
+//         HAL_SetPWMDisabled(handles[i], &status);
+//         HAL_LatchPWMZero(handles[i], &status);
+//         failed += status != 0;
+//     }
+//     return failed;
+// }
+import "C"
+
+// Pulse widths in milliseconds for a PWM speed controller
+type PWMProfile struct {
+	Max, DeadbandMax, Center, DeadbandMin, Min float64
+}
+
+var (
+	SparkProfile    = PWMProfile{2.003, 1.55, 1.50, 1.46, 0.999}
+	VictorSPProfile = PWMProfile{2.004, 1.52, 1.50, 1.48, 0.997}
+	TalonSRProfile  = PWMProfile{2.037, 1.539, 1.513, 1.487, 0.989}
+)
+
+// Holds the speeds of PWM controllers and writes all of them with one C call at the end of the tick.
+// Outputs are zero latched while the robot is disabled and are only written again once it is enabled
+type PWMBank struct {
+	handles  []C.HAL_DigitalHandle
+	speeds   []C.double
+	disabled bool
+	errors   int
+}
+
+type PWMController struct {
+	bank     *PWMBank
+	index    int
+	inverted bool
+}
+
+func NewPWMBank() *PWMBank {
+	bank := &PWMBank{disabled: true}
+	onTickEnd(bank.Flush)
+	return bank
+}
+
+func (bank *PWMBank) Add(channel int, profile PWMProfile) *PWMController {
+	status := C.int32_t(0)
+	handle := C.HAL_InitializePWMPort(C.HAL_GetPort(C.int32_t(channel)), &status)
+	handleErrorStatus(status)
+	C.HAL_SetPWMConfig(handle, C.double(profile.Max), C.double(profile.DeadbandMax), C.double(profile.Center),
+		C.double(profile.DeadbandMin), C.double(profile.Min), &status)
+	handleErrorStatus(status)
+	C.HAL_SetPWMEliminateDeadband(handle, 0, &status)
+	handleErrorStatus(status)
+	// All of the supported controllers expect the full 5.05 ms period
+	C.HAL_SetPWMPeriodScale(handle, 0, &status)
+	handleErrorStatus(status)
+	C.HAL_LatchPWMZero(handle, &status)
+	handleErrorStatus(status)
+	bank.handles = append(bank.handles, handle)
+	bank.speeds = append(bank.speeds, 0)
+	return &PWMController{bank: bank, index: len(bank.handles) - 1}
+}
+
+// Failed writes are counted instead of panicking, so one bad port does not stop the loop. A failed disable is tried
+// again next tick
+func (bank *PWMBank) Flush() {
+	if len(bank.handles) == 0 {
+		return
+	}
+	if currentMode == Disabled || currentMode == None {
+		if !bank.disabled {
+			failed := int(C.disablePWMs(&bank.handles[0], C.int32_t(len(bank.handles))))
+			bank.errors += failed
+			for i := range bank.speeds {
+				bank.speeds[i] = 0 // Do not jump back to the last output when enabled again
+			}
+			bank.disabled = failed == 0
+		}
+		return
+	}
+	bank.disabled = false
+	bank.errors += int(C.setPWMSpeeds(&bank.handles[0], &bank.speeds[0], C.int32_t(len(bank.handles))))
+}
+
+// Number of port writes that failed
+func (bank *PWMBank) Errors() int {
+	return bank.errors
+}
+
+func (controller *PWMController) SetInverted(inverted bool) {
+	controller.inverted = inverted
+}
+
+// Takes effect at the end of the tick
+func (controller *PWMController) Set(output float64) {
+	if controller.inverted {
+		output = -output
+	}
+	controller.bank.speeds[controller.index] = C.double(output)
+}
@@ -0,0 +1,73 @@
+package rev
+
+// #include "rev.h"
+import "C"
+import "unsafe"
+
+// What a Spark's value means, the same numbers as c_SparkMax_ControlType
+type ControlType int
+
+const (
+	DutyCycle ControlType = 0
+	Velocity  ControlType = 1 // RPM, held by the Spark's own loop
+	Position  ControlType = 3 // Rotations
+)
+
+// Sparks that are set and read together, each direction with one call into C however many Sparks there are
+type SparkBatch struct {
+	Sparks    []*Spark
+	Positions []float64 // Rotations, filled in by ReadPositions
+
+	handles []unsafe.Pointer // C memory, so Go may hold them in a slice it passes to C
+	types   []C.int
+	values  []C.double
+}
+
+func NewSparkBatch(sparks ...*Spark) *SparkBatch {
+	batch := &SparkBatch{
+		Sparks:    sparks,
+		Positions: make([]float64, len(sparks)),
+		handles:   make([]unsafe.Pointer, len(sparks)),
+		types:     make([]C.int, len(sparks)),
+		values:    make([]C.double, len(sparks)),
+	}
+	for i, spark := range sparks {
+		batch.handles[i] = spark.handle
+	}
+	return batch
+}
+
+// Queues a value for the Spark at index i, which is applied by the next Send
+func (batch *SparkBatch) Set(i int, controlType ControlType, value float64) {
+	batch.types[i], batch.values[i] = C.int(controlType), C.double(value)
+	batch.Sparks[i].mode, batch.Sparks[i].output = controlType, value
+}
+
+func (batch *SparkBatch) Send() {
+	if len(batch.handles) > 0 {
+		// Through a local, given &batch.handles[0] directly cgo allocates a closure to check it on every call
+		handles := &batch.handles[0]
+		C.REV_SetMany(handles, &batch.types[0], &batch.values[0], C.int(len(batch.handles)))
+	}
+}
+
+func (batch *SparkBatch) ReadPositions() {
+	if len(batch.handles) > 0 {
+		handles := &batch.handles[0]
+		C.REV_GetSensorPositions(handles, (*C.double)(unsafe.Pointer(&batch.Positions[0])), C.int(len(batch.handles)))
+	}
+}
+
+// Send and ReadPositions with a call into C for each Spark, the crossings a batch saves, for measuring them
+func (batch *SparkBatch) SendEach() {
+	for i := range batch.handles {
+		handle := &batch.handles[i]
+		C.REV_SetMany(handle, &batch.types[i], &batch.values[i], 1)
+	}
+}
+
+func (batch *SparkBatch) ReadPositionsEach() {
+	for i, spark := range batch.Sparks {
+		batch.Positions[i] = spark.GetSensorPosition()
+	}
+}
@@ -8,6 +8,20 @@ CSpark* REV_CreateSpark(int port);
 
 void REV_Set(CSpark* spark, double output);
 
+double REV_GetSensorPosition(CSpark* spark);
+
+double REV_GetSensorVelocity(CSpark* spark);
+
+double REV_GetAppliedOutput(CSpark* spark);
+
+// Sets every Spark to its control type and value in one call, types are c_SparkMax_ControlType values
+void REV_SetMany(CSpark* const* sparks, const int* types, const double* values, int count);
+
+void REV_GetSensorPositions(CSpark* const* sparks, double* positions, int count);
+
+// Gains of the closed loop in slot 0
+void REV_ConfigPID(CSpark* spark, double kP, double kI, double kD, double kF);
+
 #ifdef __cplusplus
 }
 #endif
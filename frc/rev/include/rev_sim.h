@@ -0,0 +1,11 @@
+#include "rev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+double REV_SimGetOutput(CSpark* spark);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,15 +1,68 @@
+//go:build !sim
+// +build !sim
+
 #include "rev.h"
+#include "trace.h"
 
 #include "rev/CANSparkMaxDriver.h"
 
 #define SPARK(spark) ((c_SparkMax_handle) spark)
 
+extern std::atomic<TraceHook> REV_traceHook;
+
 extern "C" {
     CSpark* REV_CreateSpark(int port) {
+        TraceScope scope(REV_traceHook, "REV_CreateSpark");
         return (CSpark*) c_SparkMax_Create(port, c_SparkMax_kBrushless);
     }
 
     void REV_Set(CSpark* spark, double output) {
+        TraceScope scope(REV_traceHook, "REV_Set");
         c_SparkMax_SetpointCommand(SPARK(spark), output, c_SparkMax_kDutyCycle, 0, 0.0f, 0);
     }
+
+    double REV_GetSensorPosition(CSpark* spark) {
+        TraceScope scope(REV_traceHook, "REV_GetSensorPosition");
+        c_SparkMax_PeriodicStatus2 status;
+        c_SparkMax_GetPeriodicStatus2(SPARK(spark), &status);
+        return status.sensorPosition;
+    }
+
+    double REV_GetSensorVelocity(CSpark* spark) {
+        TraceScope scope(REV_traceHook, "REV_GetSensorVelocity");
+        c_SparkMax_PeriodicStatus1 status;
+        c_SparkMax_GetPeriodicStatus1(SPARK(spark), &status);
+        return status.sensorVelocity;
+    }
+
+    double REV_GetAppliedOutput(CSpark* spark) {
+        TraceScope scope(REV_traceHook, "REV_GetAppliedOutput");
+        float output = 0;
+        c_SparkMax_GetAppliedOutput(SPARK(spark), &output);
+        return output;
+    }
+
+    void REV_SetMany(CSpark* const* sparks, const int* types, const double* values, int count) {
+        TraceScope scope(REV_traceHook, "REV_SetMany");
+        for (int i = 0; i < count; i++) {
+            c_SparkMax_SetpointCommand(SPARK(sparks[i]), values[i], (c_SparkMax_ControlType) types[i], 0, 0.0f, 0);
+        }
+    }
+
+    void REV_GetSensorPositions(CSpark* const* sparks, double* positions, int count) {
+        TraceScope scope(REV_traceHook, "REV_GetSensorPositions");
+        for (int i = 0; i < count; i++) {
+            c_SparkMax_PeriodicStatus2 status;
+            c_SparkMax_GetPeriodicStatus2(SPARK(sparks[i]), &status);
+            positions[i] = status.sensorPosition;
+        }
+    }
+
+    void REV_ConfigPID(CSpark* spark, double kP, double kI, double kD, double kF) {
+        TraceScope scope(REV_traceHook, "REV_ConfigPID");
+        c_SparkMax_SetP(SPARK(spark), 0, kP);
+        c_SparkMax_SetI(SPARK(spark), 0, kI);
+        c_SparkMax_SetD(SPARK(spark), 0, kD);
+        c_SparkMax_SetFF(SPARK(spark), 0, kF);
+    }
 }
\ No newline at end of file
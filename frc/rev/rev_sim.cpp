@@ -0,0 +1,130 @@
+//go:build sim
+// +build sim
+
+#include <string>
+
+#include "simcan.h"
+#include "simdevice.h"
+#include "rev_sim.h"
+#include "trace.h"
+
+#define DUTY_CYCLE_TYPE 0
+#define VELOCITY_TYPE 1
+#define POSITION_TYPE 3
+
+// Frame IDs before the device number is added
+#define DUTY_CYCLE_FRAME 0x02050080
+#define VELOCITY_FRAME 0x02050480
+#define POSITION_FRAME 0x02050C80
+#define VELOCITY_STATUS_FRAME 0x02051840
+#define POSITION_STATUS_FRAME 0x02051880
+
+// Stand-in for the Spark MAX on the desktop, its state lives in a HAL sim device named "SPARK MAX[port]"
+namespace sim {
+    struct Spark {
+        int port;
+        HAL_SimDeviceHandle device;
+        HAL_SimValueHandle output, position, velocity;
+        double kP, kF;
+    };
+
+    // The setpoint as a little endian float, in a frame of its own for each type
+    void sendSetpoint(Spark* spark, int type, double setpoint) {
+        uint32_t id = type == VELOCITY_TYPE ? VELOCITY_FRAME : type == POSITION_TYPE ? POSITION_FRAME : DUTY_CYCLE_FRAME;
+        float value = (float) setpoint;
+        uint8_t data[8] = {};
+        memcpy(data, &value, sizeof(value));
+        SimSendFrame(id | spark->port, data, sizeof(data));
+    }
+
+    // Velocity and position each come in their own status frame, as a little endian float at the start
+    void receiveStatus(Spark* spark) {
+        uint8_t data[8];
+        float value;
+        if (SimReceiveFrame(VELOCITY_STATUS_FRAME | spark->port, data)) {
+            memcpy(&value, data, sizeof(value));
+            SimSetDouble(spark->velocity, value);
+        }
+        if (SimReceiveFrame(POSITION_STATUS_FRAME | spark->port, data)) {
+            memcpy(&value, data, sizeof(value));
+            SimSetDouble(spark->position, value);
+        }
+    }
+
+    // A Spark closes its loop every millisecond, the stand-in only each time it is set and only with kP and kF
+    double closedLoop(Spark* spark, int type, double setpoint) {
+        receiveStatus(spark);
+        double sensor = SimGetDouble(type == POSITION_TYPE ? spark->position : spark->velocity);
+        double output = spark->kF * setpoint + spark->kP * (setpoint - sensor);
+        return output > 1 ? 1 : output < -1 ? -1 : output;
+    }
+}
+
+#define SPARK(spark) ((sim::Spark*) spark)
+
+extern std::atomic<TraceHook> REV_traceHook;
+
+extern "C" {
+    CSpark* REV_CreateSpark(int port) {
+        TraceScope scope(REV_traceHook, "REV_CreateSpark");
+        std::string name = "SPARK MAX[" + std::to_string(port) + "]";
+        auto spark = new sim::Spark{port, HAL_CreateSimDevice(name.c_str())};
+        spark->output = SimCreateDouble(spark->device, "Output", true, 0.0);
+        spark->position = SimCreateDouble(spark->device, "Position", false, 0.0);
+        spark->velocity = SimCreateDouble(spark->device, "Velocity", false, 0.0);
+        return (CSpark*) spark;
+    }
+
+    void REV_Set(CSpark* spark, double output) {
+        TraceScope scope(REV_traceHook, "REV_Set");
+        sim::sendSetpoint(SPARK(spark), DUTY_CYCLE_TYPE, output);
+        SimSetDouble(SPARK(spark)->output, output);
+    }
+
+    double REV_GetSensorPosition(CSpark* spark) {
+        TraceScope scope(REV_traceHook, "REV_GetSensorPosition");
+        sim::receiveStatus(SPARK(spark));
+        return SimGetDouble(SPARK(spark)->position);
+    }
+
+    double REV_GetSensorVelocity(CSpark* spark) {
+        TraceScope scope(REV_traceHook, "REV_GetSensorVelocity");
+        sim::receiveStatus(SPARK(spark));
+        return SimGetDouble(SPARK(spark)->velocity);
+    }
+
+    double REV_GetAppliedOutput(CSpark* spark) {
+        TraceScope scope(REV_traceHook, "REV_GetAppliedOutput");
+        return SimGetDouble(SPARK(spark)->output);
+    }
+
+    void REV_SetMany(CSpark* const* sparks, const int* types, const double* values, int count) {
+        TraceScope scope(REV_traceHook, "REV_SetMany");
+        for (int i = 0; i < count; i++) {
+            sim::sendSetpoint(SPARK(sparks[i]), types[i], values[i]);
+            double output = values[i];
+            if (types[i] != DUTY_CYCLE_TYPE) {
+                output = sim::closedLoop(SPARK(sparks[i]), types[i], values[i]);
+            }
+            SimSetDouble(SPARK(sparks[i])->output, output);
+        }
+    }
+
+    void REV_GetSensorPositions(CSpark* const* sparks, double* positions, int count) {
+        TraceScope scope(REV_traceHook, "REV_GetSensorPositions");
+        for (int i = 0; i < count; i++) {
+            sim::receiveStatus(SPARK(sparks[i]));
+            positions[i] = SimGetDouble(SPARK(sparks[i])->position);
+        }
+    }
+
+    void REV_ConfigPID(CSpark* spark, double kP, double kI, double kD, double kF) {
+        TraceScope scope(REV_traceHook, "REV_ConfigPID");
+        SPARK(spark)->kP = kP;
+        SPARK(spark)->kF = kF;
+    }
+
+    double REV_SimGetOutput(CSpark* spark) {
+        return SimGetDouble(SPARK(spark)->output);
+    }
+}
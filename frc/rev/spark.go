@@ -1,8 +1,7 @@
 package rev
 
-// #cgo CFLAGS: -I${SRCDIR}/include
-// #cgo CXXFLAGS: -I${SRCDIR}/include
-// #cgo LDFLAGS: -L${SRCDIR}/../lib/athena -lwpiHal -lwpiutil -lstdc++ -lm -lFRC_NetworkCommunication -lNiFpga -lNiFpgaLv -lniriodevenum -lniriosession -lNiRioSrv -lRoboRIO_FRC_ChipObject -lvisa -Llib/athena -lSparkMaxDriver
+// #cgo CFLAGS: -I${SRCDIR}/include -I${SRCDIR}/../include
+// #cgo CXXFLAGS: -I${SRCDIR}/include -I${SRCDIR}/../include
 // #include "rev.h"
 import "C"
 import "unsafe"
@@ -10,12 +9,44 @@ import "unsafe"
 type Spark struct {
 	port   int
 	handle unsafe.Pointer
+	mode   ControlType
+	output float64
 }
 
 func NewSpark(port int) *Spark {
-	return &Spark{port, C.REV_CreateSpark(C.int(port))}
+	return &Spark{port: port, handle: C.REV_CreateSpark(C.int(port))}
 }
 
-func (talon *Spark) Set(output float64) {
-	C.REV_Set(talon.handle, C.double(output))
+func (spark *Spark) Set(output float64) {
+	spark.mode, spark.output = DutyCycle, output
+	C.REV_Set(spark.handle, C.double(output))
+}
+
+// Last value given to Set or a batch, in the units of Mode, without asking the Spark
+func (spark *Spark) Output() float64 {
+	return spark.output
+}
+
+func (spark *Spark) Mode() ControlType {
+	return spark.mode
+}
+
+// Fraction of full power the Spark is applying whatever its control type, asked of the Spark
+func (spark *Spark) AppliedOutput() float64 {
+	return float64(C.REV_GetAppliedOutput(spark.handle))
+}
+
+// Rotations
+func (spark *Spark) GetSensorPosition() float64 {
+	return float64(C.REV_GetSensorPosition(spark.handle))
+}
+
+// RPM
+func (spark *Spark) GetSensorVelocity() float64 {
+	return float64(C.REV_GetSensorVelocity(spark.handle))
+}
+
+// Gains of the Spark's own closed loop, where an output of 1 is full power
+func (spark *Spark) ConfigPID(kP, kI, kD, kF float64) {
+	C.REV_ConfigPID(spark.handle, C.double(kP), C.double(kI), C.double(kD), C.double(kF))
 }
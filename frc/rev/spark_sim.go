@@ -0,0 +1,12 @@
+//go:build sim
+// +build sim
+
+package rev
+
+// #cgo CXXFLAGS: -I${SRCDIR}/../include -I${SRCDIR}/../halsim/include
+// #include "rev_sim.h"
+import "C"
+
+func (spark *Spark) SimOutput() float64 {
+	return float64(C.REV_SimGetOutput(spark.handle))
+}
@@ -0,0 +1,7 @@
+#include "trace.h"
+
+std::atomic<TraceHook> REV_traceHook;
+
+extern "C" void REV_SetTraceHook(TraceHook hook) {
+    REV_traceHook.store(hook);
+}
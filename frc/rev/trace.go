@@ -0,0 +1,11 @@
+package rev
+
+// #include "trace.h"
+// void REV_SetTraceHook(TraceHook hook);
+import "C"
+import "unsafe"
+
+// Has every call into the vendor library recorded by hook, a C TraceHook, nil stops it
+func SetTraceHook(hook unsafe.Pointer) {
+	C.REV_SetTraceHook(C.TraceHook(hook))
+}
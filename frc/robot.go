@@ -1,13 +1,48 @@
 package frc
 
 // #cgo CFLAGS: -I${SRCDIR}/include
-// #cgo LDFLAGS: -L${SRCDIR}/lib/athena -lwpiHal -lwpiutil -lstdc++ -lm -lFRC_NetworkCommunication -lNiFpga -lNiFpgaLv -lniriodevenum -lniriosession -lNiRioSrv -lRoboRIO_FRC_ChipObject -lvisa
 // #include "hal.h"
+//
+// // Results are returned by value, passing the address of a Go variable to C would move it to the heap
+// typedef struct {
+//     uint64_t time;
+//     int32_t status;
+// } fpgaTime;
+//
+// static fpgaTime readFPGATime(void) {
+//     fpgaTime result = {0, 0};
+//     result.time = HAL_GetFPGATime(&result.status);
+//     return result;
+// }
+//
+// static uint8_t readControlFlags(void) {
+//     HAL_ControlWord word;
+//     HAL_GetControlWord(&word);
+//     return *(uint8_t*) &word;
+// }
+//
+// static float readJoystickAxis(int32_t port, int32_t axis) {
+//     HAL_JoystickAxes axes;
+//     HAL_GetJoystickAxes(port, &axes);
+//     return axes.axes[axis];
+// }
+//
+// static void readJoystickAxes(int32_t port, float* values, int32_t count) {
+//     HAL_JoystickAxes axes;
+//     HAL_GetJoystickAxes(port, &axes);
+//     for (int32_t i = 0; i < count; i++) {
+//         values[i] = i < axes.count ? axes.axes[i] : 0;
+//     }
+// }
 import "C"
 import (
 	"fmt"
+	"go-frc/frc/datalog"
+	"go-frc/frc/drive"
 	"go-frc/frc/phoenix"
+	"math"
 	"os"
+	"time"
 	"unsafe"
 )
 
@@ -28,16 +63,56 @@ const (
 	Test
 )
 
+var modeNames = [...]string{None: "none", Disabled: "disabledPeriodic", Autonomous: "autonomousPeriodic",
+	Teleop: "teleopPeriodic", Test: "testPeriodic"}
+
 const (
 	Period = 0.02 // Seconds, should correspond to running the robot loop 50 times a second
+
+	DriveTicksPerMeter = 4096 / (2 * math.Pi * 0.0762) // Mag encoder on the gearbox output, 3 inch wheels
+	DriveTrackWidth    = 0.6                           // Meters between the left and right wheels
 )
 
+// Drive forward autonomous, exported so the tuning harness can sweep the gains
+type DriveGains struct {
+	KP, KD   float64
+	Distance float64 // Meters
+}
+
 var (
 	right, left *phoenix.Talon
+	pigeon      *phoenix.Pigeon
+	// Field pose from the drive encoders and the Pigeon, corrected by vision through AddVisionPose
+	poseEstimator *drive.PoseEstimator
+	pdp           *PDP
+	brownout      *BrownoutLimiter
+	currentMode   = None
+	AutoGains     = DriveGains{KP: 1.2, KD: 0.1, Distance: 3}
+	autoStart     float64
+	// Where every received CAN frame is recorded, empty to turn recording off
+	CANLogPath  = ""
+	canRecorder *CANRecorder
+	canLogFile  *os.File
+	// Where a record of every tick is written, empty to turn it off
+	DataLogPath = ""
+	dataLog     *DataLog
+	dataLogFile *os.File
+	// Where live telemetry is sent, such as "10.12.34.5:5800" for a dashboard, empty to turn it off
+	TelemetryAddress = ""
+	TelemetryRate    = 20.0 // Datagrams per second, each carrying the ticks since the one before
+	// How late each tick started, in the same buckets as the jitter check
+	loopJitter = NewHistogram(JitterBounds)
+	// Run after the periodic functions every tick, used to flush batched outputs
+	tickEndHooks []func()
 )
 
 func hasFlag(b, i byte) bool {
-	return b & i != 0
+	return b&i != 0
+}
+
+func onTickEnd(hook func()) {
+	tickEndHooks = append(tickEndHooks, hook)
+	tickEndSpans = append(tickEndSpans, NewSpan(functionName(hook)))
 }
 
 func handleErrorStatus(status C.int32_t) {
@@ -47,26 +122,19 @@ func handleErrorStatus(status C.int32_t) {
 }
 
 func getHalStatusFlags() byte {
-	var cControlWord C.HAL_ControlWord
-	C.HAL_GetControlWord(&cControlWord)
 	// It is a bit field in C, which does not play nicely with CGo
-	// So we have to convert it to a raw byte array and read the first byte as the flags
-	// This does leave a little memory which is technically not part of the flags but we ignore it
-	flags := C.GoBytes(unsafe.Pointer(&cControlWord), C.sizeof_HAL_ControlWord)[0]
-	return flags
+	// So the C side reads the first byte of it as the flags
+	return byte(C.readControlFlags())
 }
 
 func getFPGATime() float64 {
-	status := C.int32_t(0)
-	time := float64(C.HAL_GetFPGATime(&status)) * 1e-6
-	handleErrorStatus(status)
-	return time
+	result := C.readFPGATime()
+	handleErrorStatus(result.status)
+	return float64(result.time) * 1e-6
 }
 
 func getJoystickAxis(port, axis int) float64 {
-	var cAxes C.HAL_JoystickAxes
-	C.HAL_GetJoystickAxes(C.int32_t(port), &cAxes)
-	return float64(cAxes.axes[axis])
+	return float64(C.readJoystickAxis(C.int32_t(port), C.int32_t(axis)))
 }
 
 func Start() {
@@ -74,34 +142,45 @@ func Start() {
 		os.Exit(-1)
 	}
 	fmt.Println("HAL Initialized")
+	applyGCConfig(GCTuning)
+	if TracePath != "" {
+		StartTrace()
+	}
+	if JitterCheck.Ticks > 0 {
+		runJitterCheck(JitterCheck)
+		return
+	}
 
 	robotInit()
 
 	C.HAL_ObserveUserProgramStarting()
-	status := C.int32_t(0)
-	notifier := C.HAL_InitializeNotifier(&status)
-	handleErrorStatus(status)
-
-	expirationTime := getFPGATime() + Period
-	C.HAL_UpdateNotifierAlarm(notifier, C.uint64_t(expirationTime * 1e6), &status)
-	handleErrorStatus(status)
+	timer := newLoopTimer(Period)
+	defer timer.Close()
 
-	lastMode := None
 	modeFunc := func(mode int, init, periodic func()) {
-		if lastMode != mode {
+		if currentMode != mode {
+			// Each enabled stretch gets its own timings, printed when it ends
+			if mode == Disabled && currentMode != None {
+				fmt.Print(SpanSummary())
+				ResetSpans()
+				if isTracing() {
+					writeTraceInBackground()
+				}
+			}
+			currentMode = mode
 			init()
 		}
-		periodic()
+		checkAllocations(0, modeSpans[mode], periodic)
 	}
 	for {
-		currentTime := C.HAL_WaitForNotifierAlarm(notifier, &status)
-		if currentTime == 0 || status != 0 {
+		lateness, ok := timer.Wait()
+		if !ok {
 			break
 		}
-		expirationTime += Period
-		C.HAL_UpdateNotifierAlarm(notifier, C.uint64_t(expirationTime * 1e6), &status)
-		handleErrorStatus(status)
-
+		loopJitter.Add(lateness)
+		traceBegin(tickSpan.trace)
+		now := getFPGATime()
+		deadline := now - lateness + Period
 		flags := getHalStatusFlags()
 		isDisabled := !hasFlag(flags, FEnabled) || !hasFlag(flags, FDSAttached)
 		if isDisabled {
@@ -125,10 +204,34 @@ func Start() {
 				testPeriodic()
 			})
 		}
-		robotPeriodic()
+		checkAllocations(1, robotSpan, robotPeriodic)
+		for i, hook := range tickEndHooks {
+			checkAllocations(2+i, tickEndSpans[i], hook)
+		}
+		nextAllocationTurn(2 + len(tickEndHooks))
+		// Ended before the tick is logged, so telemetry carries this tick's time and not the one before
+		tickSpan.start = now
+		tickSpan.End()
+		logTick(now, flags)
+		collectInSlack(deadline)
+	}
+	// Only reached in the simulation, a robot runs until it is switched off
+	if isTracing() {
+		writeTraceNow()
+	}
+	if dataLog != nil {
+		dataLog.Close()
+	}
+	if dataLogFile != nil {
+		dataLogFile.Close()
+	}
+	if canRecorder != nil {
+		canRecorder.Close()
+		canLogFile.Close()
+	}
+	if telemetryPublisher != nil {
+		telemetryPublisher.Close()
 	}
-	C.HAL_StopNotifier(notifier, &status)
-	C.HAL_CleanNotifier(notifier, &status)
 }
 
 func robotInit() {
@@ -138,10 +241,86 @@ func robotInit() {
 	left = phoenix.NewTalon(1)
 	phoenix.NewSlaveTalon(2, left)
 	phoenix.NewSlaveTalon(3, left)
+	pigeon = phoenix.NewPigeon(0)
+	// Two seconds of updates, longer than any camera takes, at the follower's rate since it is the faster one
+	poseEstimator = drive.NewPoseEstimator(int(2 * math.Max(FollowRate, 1/Period)))
+	leftDistance, rightDistance, gyro := readDrive()
+	poseEstimator.Reset(drive.Pose{}, leftDistance, rightDistance, gyro)
+	pdp = NewPDP(0, 20*time.Millisecond)
+	brownout = NewBrownoutLimiter()
+	if CANLogPath != "" {
+		if file, err := os.Create(CANLogPath); err == nil {
+			canLogFile = file
+			canRecorder = NewCANRecorder(file, 10*time.Millisecond)
+		} else {
+			fmt.Println(err)
+		}
+	}
+	OutputSignals[0] = datalog.Signal{Name: "left output", Resolution: 1e-3}
+	OutputSignals[1] = datalog.Signal{Name: "right output", Resolution: 1e-3}
+	SensorSignals[0] = datalog.Signal{Name: "left position", Units: "m", Resolution: 1e-4}
+	SensorSignals[1] = datalog.Signal{Name: "right position", Units: "m", Resolution: 1e-4}
+	SensorSignals[2] = datalog.Signal{Name: "left velocity", Units: "m/s", Resolution: 1e-3}
+	SensorSignals[3] = datalog.Signal{Name: "right velocity", Units: "m/s", Resolution: 1e-3}
+	SensorSignals[4] = datalog.Signal{Name: "battery voltage", Units: "V", Resolution: 1e-2}
+	SensorSignals[5] = datalog.Signal{Name: "total current", Units: "A", Resolution: 1e-2}
+	SensorSignals[6] = datalog.Signal{Name: "pose x", Units: "m", Resolution: 1e-3}
+	SensorSignals[7] = datalog.Signal{Name: "pose y", Units: "m", Resolution: 1e-3}
+	SensorSignals[8] = datalog.Signal{Name: "pose heading", Units: "rad", Resolution: 1e-3}
+	if DataLogPath != "" {
+		file, err := os.Create(DataLogPath)
+		if err == nil {
+			dataLogFile = file
+			dataLog, err = NewDataLog(file, 4096) // A minute and a half of ticks before anything is dropped
+		}
+		if err != nil {
+			fmt.Println(err)
+		}
+	}
+	go reportPhoenixErrors()
+	simInit()
+	// Last, so the spans of every tick end hook are published too
+	if TelemetryAddress != "" {
+		if err := startTelemetry(); err != nil {
+			fmt.Println(err)
+		}
+	}
 }
 
-func disabledInit() {
+// Outputs are the left and right drive, sensors the drive positions in meters and velocities in meters per second,
+// then the battery voltage, total current and the field pose
+func logTick(now float64, flags byte) {
+	if dataLog == nil && telemetryPublisher == nil {
+		return
+	}
+	record := &tickRecord
+	*record = LogRecord{Time: now, Flags: flags, Mode: uint8(currentMode)}
+	C.readJoystickAxes(0, (*C.float)(unsafe.Pointer(&record.Axes[0])), LogAxes)
+	if followTask == nil {
+		record.Outputs[0], record.Outputs[1] = float32(left.Output()), float32(right.Output())
+	} else {
+		// The follower sets velocities from its own thread, so ask the Talons what they apply
+		record.Outputs[0], record.Outputs[1] = float32(left.AppliedOutput()), float32(right.AppliedOutput())
+	}
+	record.Sensors[0] = float32(left.GetSensorPosition() / DriveTicksPerMeter)
+	record.Sensors[1] = float32(right.GetSensorPosition() / DriveTicksPerMeter)
+	record.Sensors[2] = float32(left.GetSensorVelocity() / DriveTicksPerMeter * 10)
+	record.Sensors[3] = float32(right.GetSensorVelocity() / DriveTicksPerMeter * 10)
+	snapshot := pdp.Snapshot()
+	record.Sensors[4], record.Sensors[5] = float32(snapshot.Voltage), float32(snapshot.TotalCurrent)
+	pose := RobotPose()
+	record.Sensors[6], record.Sensors[7], record.Sensors[8] = float32(pose.X), float32(pose.Y), float32(pose.Heading)
+	if dataLog != nil {
+		if slot := dataLog.Reserve(); slot != nil {
+			*slot = *record
+			dataLog.Commit()
+		}
+	}
+	publishTick(record)
+}
 
+func disabledInit() {
+	stopFollowing()
 }
 
 func disabledPeriodic() {
@@ -149,11 +328,37 @@ func disabledPeriodic() {
 }
 
 func robotPeriodic() {
+	// While following a path the follower keeps the pose up to date, at its faster rate
+	if followTask == nil {
+		leftDistance, rightDistance, gyro := readDrive()
+		poseLock.Lock()
+		poseEstimator.Update(getFPGATime(), leftDistance, rightDistance, gyro)
+		poseLock.Unlock()
+	}
+}
 
+// Meters each side has travelled forward and the Pigeon's yaw in radians
+func readDrive() (leftDistance, rightDistance, gyro float64) {
+	return left.GetSensorPosition() / DriveTicksPerMeter, -right.GetSensorPosition() / DriveTicksPerMeter,
+		pigeon.Yaw() * math.Pi / 180
 }
 
-func testInit() {
+// Where the robot is on the field, as of the last tick or the follower's last run
+func RobotPose() drive.Pose {
+	poseLock.Lock()
+	defer poseLock.Unlock()
+	return poseEstimator.Pose()
+}
 
+// Corrects the field pose with one seen by a camera at time, in FPGA seconds
+func AddVisionPose(time float64, pose drive.Pose) bool {
+	poseLock.Lock()
+	defer poseLock.Unlock()
+	return poseEstimator.AddVision(time, pose)
+}
+
+func testInit() {
+	stopFollowing()
 }
 
 func testPeriodic() {
@@ -161,19 +366,44 @@ func testPeriodic() {
 }
 
 func autonomousInit() {
-
+	autoStart = driveDistance()
+	if AutoTrajectory != nil && len(AutoTrajectory.States) > 0 {
+		leftDistance, rightDistance, gyro := readDrive()
+		poseLock.Lock()
+		poseEstimator.Reset(AutoTrajectory.States[0].Pose, leftDistance, rightDistance, gyro)
+		poseLock.Unlock()
+		startFollowing(AutoTrajectory, AutoController)
+	}
 }
 
 func autonomousPeriodic() {
+	if followTask != nil {
+		return
+	}
+	travelled := driveDistance() - autoStart
+	output := AutoGains.KP*(AutoGains.Distance-travelled) - AutoGains.KD*driveVelocity()
+	output = math.Max(-1, math.Min(1, output))
+	left.Set(output)
+	right.Set(-output)
 }
 
-func teleopInit() {
+// Meters forward, the right side is mirrored so its sensor counts down
+func driveDistance() float64 {
+	return (left.GetSensorPosition() - right.GetSensorPosition()) / 2 / DriveTicksPerMeter
+}
 
+func driveVelocity() float64 {
+	return (left.GetSensorVelocity() - right.GetSensorVelocity()) / 2 / DriveTicksPerMeter * 10
+}
+
+func teleopInit() {
+	stopFollowing()
 }
 
 func teleopPeriodic() {
 	throttle := getJoystickAxis(0, 1)
 	turn := getJoystickAxis(0, 0)
-	left.Set(turn - throttle)
-	right.Set(turn + throttle)
+	scale := brownout.Update(pdp.Snapshot())
+	left.Set(scale * (turn - throttle))
+	right.Set(scale * (turn + throttle))
 }
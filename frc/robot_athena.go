@@ -0,0 +1,7 @@
+//go:build !sim || socketcan
+// +build !sim socketcan
+
+package frc
+
+// Physics is only attached in the simulation build
+func simInit() {}
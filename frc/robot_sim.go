@@ -0,0 +1,70 @@
+//go:build sim && !socketcan
+// +build sim,!socketcan
+
+package frc
+
+import (
+	"go-frc/frc/halsim"
+	"go-frc/frc/sim"
+	"math"
+	"math/rand"
+)
+
+// Physical properties of the simulated robot, set before Start to randomize a run
+type SimParameters struct {
+	BatteryVoltage    float64
+	BatteryResistance float64 // Ohms, including wiring
+	Friction          float64 // Viscous drag on each side of the drive
+	Mass              float64
+	EncoderNoise      float64 // Standard deviation in ticks
+	Seed              int64
+}
+
+var (
+	SimConfig = SimParameters{BatteryVoltage: 12.5, BatteryResistance: 0.02, Mass: 60, Seed: 1}
+
+	simDrive    *sim.DifferentialDrives
+	simBindings sim.Bindings
+	simCurrents [PDPChannels]float64
+	// Arrays rather than SimValue.Set, whose arguments escape to the heap on every call
+	simYaw     [1]halsim.SimValue
+	simYawDegs [1]float64
+)
+
+// Model of the drive attached to the simulated Talons, for checking what the robot actually did
+func SimDrive() *sim.DifferentialDrives {
+	return simDrive
+}
+
+// Attaches physics to the simulated Talons created in robotInit and steps it at the end of every tick
+func simInit() {
+	simDrive = sim.NewDifferentialDrives(1, sim.CIM, 3)
+	simDrive.Friction[0] = SimConfig.Friction
+	simDrive.Mass[0] = SimConfig.Mass
+	simBindings.BusVoltage = SimConfig.BatteryVoltage
+	simBindings.PositionNoise = SimConfig.EncoderNoise
+	simBindings.Random = rand.New(rand.NewSource(SimConfig.Seed))
+	simBindings.Add(sim.Talon(1), &simDrive.LeftVoltage[0], &simDrive.LeftPosition[0], &simDrive.LeftVelocity[0],
+		DriveTicksPerMeter, DriveTicksPerMeter/10)
+	// The right side is mirrored, so a positive output drives it backwards
+	simBindings.Add(sim.Talon(6).Invert(), &simDrive.RightVoltage[0], &simDrive.RightPosition[0], &simDrive.RightVelocity[0],
+		DriveTicksPerMeter, DriveTicksPerMeter/10)
+	simYaw[0] = halsim.FindSimValue("Pigeon IMU[0]", "Yaw")
+	onTickEnd(simPeriodic)
+}
+
+func simPeriodic() {
+	simBindings.ReadOutputs()
+	simDrive.Step(Period)
+	simBindings.WriteSensors()
+	simYawDegs[0] = simDrive.Heading[0] * 180 / math.Pi
+	halsim.SetSimDoubles(simYaw[:], simYawDegs[:])
+	// Each side is three motors, on the first and last three channels of the PDP
+	for i := 0; i < 3; i++ {
+		simCurrents[i] = simDrive.LeftCurrent[0] / 3
+		simCurrents[PDPChannels-1-i] = simDrive.RightCurrent[0] / 3
+	}
+	total := simDrive.LeftCurrent[0] + simDrive.RightCurrent[0]
+	simBindings.BusVoltage = SimConfig.BatteryVoltage - SimConfig.BatteryResistance*total
+	halsim.SetPDP(simBindings.BusVoltage, simCurrents[:])
+}
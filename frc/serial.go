@@ -0,0 +1,207 @@
+package frc
+
+// #include "hal.h"
+import "C"
+import (
+	"encoding/binary"
+	"math"
+	"sync"
+	"sync/atomic"
+	"syscall"
+)
+
+const (
+	SerialOnboard = C.HAL_SerialPort_Onboard
+	SerialMXP     = C.HAL_SerialPort_MXP
+
+	serialRingSize = 1 << 12 // Must be a power of two so indices can be masked
+	serialRingMask = serialRingSize - 1
+
+	visionSync0, visionSync1 = 0xA5, 0x5A
+	visionHeaderSize         = 3 // Two sync bytes and the payload length
+	visionPayloadSize        = 13
+)
+
+// Latest target sent by the vision co-processor.
+// Time is when the bytes were received, subtract it from the current time to get the latency to compensate for
+type VisionTarget struct {
+	Valid      bool
+	Yaw, Pitch float64 // Degrees
+	Distance   float64 // Meters
+	Time       float64
+	Sequence   uint64
+}
+
+// Opens a HAL serial port and hands its file descriptor to a SerialReader, which closes the port when it stops
+func OpenSerialPort(port int, baud int) *SerialReader {
+	status := C.int32_t(0)
+	handle := C.HAL_InitializeSerialPort(C.HAL_SerialPort(port), &status)
+	handleErrorStatus(status)
+	C.HAL_SetSerialBaudRate(handle, C.int32_t(baud), &status)
+	handleErrorStatus(status)
+	fd := C.HAL_GetSerialFD(handle, &status)
+	handleErrorStatus(status)
+	reader, err := newSerialReader(int(fd), getFPGATime, func() {
+		status := C.int32_t(0)
+		C.HAL_CloseSerial(handle, &status)
+	})
+	if err != nil {
+		C.HAL_CloseSerial(handle, &status)
+		panic(err)
+	}
+	return reader
+}
+
+// Reads framed vision packets from any file descriptor on a background goroutine,
+// so a pty can stand in for the UART when testing off the robot.
+// A packet is two sync bytes, the payload length, the payload and then an XOR checksum of the payload
+type SerialReader struct {
+	fd, epoll  int
+	clock      func() float64
+	ring       [serialRingSize]byte
+	head, tail uint // Total bytes written into and consumed from the ring
+	closed     int32
+	release    func()        // Closes the descriptor once the reader is done with it
+	done       chan struct{} // Closed when the reader has stopped
+	mutex      sync.Mutex
+	latest     VisionTarget
+	dropped    uint64 // Atomic
+}
+
+// The reader owns fd from then on and closes it when it stops
+func NewSerialReader(fd int, clock func() float64) (*SerialReader, error) {
+	return newSerialReader(fd, clock, func() { syscall.Close(fd) })
+}
+
+func newSerialReader(fd int, clock func() float64, release func()) (*SerialReader, error) {
+	if err := syscall.SetNonblock(fd, true); err != nil {
+		return nil, err
+	}
+	epoll, err := syscall.EpollCreate1(syscall.EPOLL_CLOEXEC)
+	if err != nil {
+		return nil, err
+	}
+	event := syscall.EpollEvent{Events: syscall.EPOLLIN, Fd: int32(fd)}
+	if err := syscall.EpollCtl(epoll, syscall.EPOLL_CTL_ADD, fd, &event); err != nil {
+		syscall.Close(epoll)
+		return nil, err
+	}
+	reader := &SerialReader{fd: fd, epoll: epoll, clock: clock, release: release, done: make(chan struct{})}
+	go reader.run()
+	return reader, nil
+}
+
+func (reader *SerialReader) run() {
+	defer close(reader.done)
+	defer reader.release()
+	defer syscall.Close(reader.epoll)
+	events := make([]syscall.EpollEvent, 1)
+	for atomic.LoadInt32(&reader.closed) == 0 {
+		// Time out periodically so that Close is noticed even when the line is silent
+		count, err := syscall.EpollWait(reader.epoll, events, 100)
+		if err == syscall.EINTR || count == 0 {
+			continue
+		}
+		if err != nil {
+			return
+		}
+		receiveTime := reader.clock()
+		for reader.fill() > 0 {
+			reader.parse(receiveTime)
+		}
+		// Nothing more will arrive once the other end has gone, and epoll would keep reporting it without waiting
+		if events[0].Events&(syscall.EPOLLHUP|syscall.EPOLLERR) != 0 {
+			return
+		}
+	}
+}
+
+// Reads straight into the free region of the ring, returns how many bytes were read
+func (reader *SerialReader) fill() int {
+	if reader.head-reader.tail == serialRingSize {
+		// Still full after parsing means no frame fits, which only happens on garbage, so throw it away
+		reader.tail = reader.head
+		atomic.AddUint64(&reader.dropped, 1)
+	}
+	start := reader.head & serialRingMask
+	end := serialRingSize
+	if free := serialRingSize - int(reader.head-reader.tail); int(start)+free < end {
+		end = int(start) + free
+	}
+	count, err := syscall.Read(reader.fd, reader.ring[start:end])
+	if err != nil || count <= 0 {
+		return 0
+	}
+	reader.head += uint(count)
+	return count
+}
+
+func (reader *SerialReader) at(index uint) byte {
+	return reader.ring[index&serialRingMask]
+}
+
+func (reader *SerialReader) parse(receiveTime float64) {
+	for reader.head-reader.tail >= visionHeaderSize {
+		if reader.at(reader.tail) != visionSync0 || reader.at(reader.tail+1) != visionSync1 {
+			reader.tail++
+			continue
+		}
+		length := uint(reader.at(reader.tail + 2))
+		frameSize := visionHeaderSize + length + 1
+		if reader.head-reader.tail < frameSize {
+			return // Wait for the rest of the frame
+		}
+		payload := reader.tail + visionHeaderSize
+		checksum := byte(0)
+		for i := uint(0); i < length; i++ {
+			checksum ^= reader.at(payload + i)
+		}
+		if length != visionPayloadSize || checksum != reader.at(payload+length) {
+			reader.tail++ // Could have been a sync pattern inside another frame, so resynchronize one byte later
+			atomic.AddUint64(&reader.dropped, 1)
+			continue
+		}
+		reader.publish(payload, receiveTime)
+		reader.tail += frameSize
+	}
+}
+
+// Decodes from the ring in place, the frame may wrap around the end so fields are gathered through the mask
+func (reader *SerialReader) publish(payload uint, receiveTime float64) {
+	var field [4]byte
+	float := func(offset uint) float64 {
+		for i := uint(0); i < 4; i++ {
+			field[i] = reader.at(payload + offset + i)
+		}
+		return float64(math.Float32frombits(binary.LittleEndian.Uint32(field[:])))
+	}
+	reader.mutex.Lock()
+	reader.latest = VisionTarget{
+		Valid:    reader.at(payload) != 0,
+		Yaw:      float(1),
+		Pitch:    float(5),
+		Distance: float(9),
+		Time:     receiveTime,
+		Sequence: reader.latest.Sequence + 1,
+	}
+	reader.mutex.Unlock()
+}
+
+// Most recent target, a Sequence of zero means nothing has been received yet
+func (reader *SerialReader) Latest() VisionTarget {
+	reader.mutex.Lock()
+	defer reader.mutex.Unlock()
+	return reader.latest
+}
+
+// Number of times bytes were discarded because of bad framing or an overflowing ring
+func (reader *SerialReader) Dropped() uint64 {
+	return atomic.LoadUint64(&reader.dropped)
+}
+
+// Stops the reader and closes its descriptor, waiting up to the reader's 100 ms poll for it to notice. The reader
+// also stops by itself when the other end hangs up
+func (reader *SerialReader) Close() {
+	atomic.StoreInt32(&reader.closed, 1)
+	<-reader.done
+}
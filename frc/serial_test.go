@@ -0,0 +1,173 @@
+//go:build sim
+// +build sim
+
+package frc
+
+import (
+	"encoding/binary"
+	"math"
+	"os"
+	"strconv"
+	"syscall"
+	"testing"
+	"time"
+	"unsafe"
+)
+
+func ioctl(fd, request uintptr, argument unsafe.Pointer) error {
+	if _, _, errno := syscall.Syscall(syscall.SYS_IOCTL, fd, request, uintptr(argument)); errno != 0 {
+		return errno
+	}
+	return nil
+}
+
+// A pseudo terminal in raw mode standing in for the UART, the test writes the master like the co-processor would
+// and the reader gets the slave's descriptor
+func openPty(t *testing.T) (*os.File, int) {
+	master, err := os.OpenFile("/dev/ptmx", os.O_RDWR|syscall.O_NOCTTY, 0)
+	if err != nil {
+		t.Skip("no pseudo terminals:", err)
+	}
+	unlock := int32(0)
+	var number uint32
+	if err := ioctl(master.Fd(), syscall.TIOCSPTLCK, unsafe.Pointer(&unlock)); err != nil {
+		t.Fatal(err)
+	}
+	if err := ioctl(master.Fd(), syscall.TIOCGPTN, unsafe.Pointer(&number)); err != nil {
+		t.Fatal(err)
+	}
+	slave, err := syscall.Open("/dev/pts/"+strconv.Itoa(int(number)), syscall.O_RDWR|syscall.O_NOCTTY, 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	var attributes syscall.Termios
+	if err := ioctl(uintptr(slave), syscall.TCGETS, unsafe.Pointer(&attributes)); err != nil {
+		t.Fatal(err)
+	}
+	attributes.Iflag &^= syscall.IGNBRK | syscall.BRKINT | syscall.PARMRK | syscall.ISTRIP | syscall.INLCR |
+		syscall.IGNCR | syscall.ICRNL | syscall.IXON
+	attributes.Oflag &^= syscall.OPOST
+	attributes.Lflag &^= syscall.ECHO | syscall.ECHONL | syscall.ICANON | syscall.ISIG | syscall.IEXTEN
+	attributes.Cflag = attributes.Cflag&^(syscall.CSIZE|syscall.PARENB) | syscall.CS8
+	if err := ioctl(uintptr(slave), syscall.TCSETS, unsafe.Pointer(&attributes)); err != nil {
+		t.Fatal(err)
+	}
+	return master, slave
+}
+
+func openTestReader(t *testing.T) (*os.File, *SerialReader) {
+	master, slave := openPty(t)
+	reader, err := NewSerialReader(slave, func() float64 { return 1.5 })
+	if err != nil {
+		t.Fatal(err)
+	}
+	return master, reader
+}
+
+func visionFrame(yaw, pitch, distance float32) []byte {
+	frame := []byte{visionSync0, visionSync1, visionPayloadSize, 1}
+	for _, value := range []float32{yaw, pitch, distance} {
+		var field [4]byte
+		binary.LittleEndian.PutUint32(field[:], math.Float32bits(value))
+		frame = append(frame, field[:]...)
+	}
+	checksum := byte(0)
+	for _, b := range frame[visionHeaderSize:] {
+		checksum ^= b
+	}
+	return append(frame, checksum)
+}
+
+func write(t *testing.T, master *os.File, data []byte) {
+	if _, err := master.Write(data); err != nil {
+		t.Fatal(err)
+	}
+}
+
+// Polls until the reader has published sequence targets
+func waitForSequence(t *testing.T, reader *SerialReader, sequence uint64) VisionTarget {
+	deadline := time.Now().Add(2 * time.Second)
+	for {
+		latest := reader.Latest()
+		if latest.Sequence >= sequence || time.Now().After(deadline) {
+			if latest.Sequence != sequence {
+				t.Fatalf("sequence %d, want %d", latest.Sequence, sequence)
+			}
+			return latest
+		}
+		time.Sleep(time.Millisecond)
+	}
+}
+
+func TestSerialReaderTornFrames(t *testing.T) {
+	master, reader := openTestReader(t)
+	defer master.Close()
+	defer reader.Close()
+
+	frame := visionFrame(12.5, -3, 4.25)
+	// Leading garbage, then the frame in pieces that each end up in their own read
+	write(t, master, []byte{0x00, visionSync0, 0x11})
+	for _, piece := range [][]byte{frame[:1], frame[1:3], frame[3:9], frame[9:]} {
+		time.Sleep(5 * time.Millisecond)
+		write(t, master, piece)
+	}
+	target := waitForSequence(t, reader, 1)
+	if !target.Valid || target.Yaw != 12.5 || target.Pitch != -3 || target.Distance != 4.25 || target.Time != 1.5 {
+		t.Errorf("got %+v", target)
+	}
+}
+
+func TestSerialReaderBadChecksum(t *testing.T) {
+	master, reader := openTestReader(t)
+	defer master.Close()
+	defer reader.Close()
+
+	bad := visionFrame(1, 2, 3)
+	bad[len(bad)-1] ^= 0xFF
+	wrongLength := visionFrame(1, 2, 3)
+	wrongLength[2] = visionPayloadSize - 1
+	write(t, master, append(append(bad, wrongLength...), visionFrame(4, 5, 6)...))
+	target := waitForSequence(t, reader, 1)
+	if target.Yaw != 4 || target.Pitch != 5 || target.Distance != 6 {
+		t.Errorf("got %+v, want the frame after the bad ones", target)
+	}
+	if reader.Dropped() < 2 {
+		t.Errorf("dropped %d, want at least one for each bad frame", reader.Dropped())
+	}
+}
+
+func TestSerialReaderRingWrap(t *testing.T) {
+	master, reader := openTestReader(t)
+	defer master.Close()
+	defer reader.Close()
+
+	// Frames do not divide the ring evenly, so over a few laps some straddle its end
+	frameSize := len(visionFrame(0, 0, 0))
+	count := 3*serialRingSize/frameSize + 1
+	var data []byte
+	for i := 0; i < count; i++ {
+		data = append(data, visionFrame(float32(i), float32(-i), float32(2*i))...)
+	}
+	write(t, master, data)
+	target := waitForSequence(t, reader, uint64(count))
+	last := float64(count - 1)
+	if target.Yaw != last || target.Pitch != -last || target.Distance != 2*last {
+		t.Errorf("got %+v, want the last frame", target)
+	}
+	if reader.Dropped() != 0 {
+		t.Errorf("dropped %d", reader.Dropped())
+	}
+}
+
+func TestSerialReaderHangUp(t *testing.T) {
+	master, reader := openTestReader(t)
+	write(t, master, visionFrame(7, 8, 9))
+	waitForSequence(t, reader, 1)
+	master.Close()
+	select {
+	case <-reader.done:
+	case <-time.After(time.Second):
+		t.Fatal("reader still running after the other end hung up")
+	}
+	reader.Close()
+}
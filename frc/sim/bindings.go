@@ -0,0 +1,96 @@
+//go:build sim
+// +build sim
+
+package sim
+
+import (
+	"fmt"
+	"go-frc/frc/halsim"
+	"math/rand"
+)
+
+// Sim device values of a simulated motor controller
+type Controller struct {
+	Output, Position, Velocity halsim.SimValue
+	Inverted                   bool // Mounted so that a positive output drives the model backwards
+}
+
+func (controller Controller) Invert() Controller {
+	controller.Inverted = !controller.Inverted
+	return controller
+}
+
+func findController(device string) Controller {
+	controller := Controller{
+		Output:   halsim.FindSimValue(device, "Output"),
+		Position: halsim.FindSimValue(device, "Position"),
+		Velocity: halsim.FindSimValue(device, "Velocity"),
+	}
+	if controller.Output == 0 {
+		panic(fmt.Sprintf("no sim device %s, create it before binding", device))
+	}
+	return controller
+}
+
+// Position in encoder ticks, velocity in ticks per 100 ms
+func Talon(port int) Controller {
+	return findController(fmt.Sprintf("Talon SRX[%d]", port))
+}
+
+// Position in rotations, velocity in RPM
+func Spark(port int) Controller {
+	return findController(fmt.Sprintf("SPARK MAX[%d]", port))
+}
+
+// Connects motor controllers to elements of model slices. Each tick ReadOutputs turns controller outputs into
+// model voltages and WriteSensors copies model positions and velocities back, each with one call into the HAL
+type Bindings struct {
+	BusVoltage    float64
+	PositionNoise float64    // Standard deviation added to positions in sensor units
+	Random        *rand.Rand // Needed when there is noise
+
+	outputs, sensors               []halsim.SimValue
+	voltages                       []*float64
+	positions, velocities          []*float64
+	positionScales, velocityScales []float64
+	signs                          []float64
+	outputBuffer, sensorBuffer     []float64
+}
+
+// Pointers must be to elements of slices that will not be reallocated, which holds for the model types here.
+// The scales convert model units into the controller's sensor units
+func (bindings *Bindings) Add(controller Controller, voltage, position, velocity *float64, positionScale, velocityScale float64) {
+	bindings.outputs = append(bindings.outputs, controller.Output)
+	bindings.sensors = append(bindings.sensors, controller.Position, controller.Velocity)
+	bindings.voltages = append(bindings.voltages, voltage)
+	bindings.positions = append(bindings.positions, position)
+	bindings.velocities = append(bindings.velocities, velocity)
+	bindings.positionScales = append(bindings.positionScales, positionScale)
+	bindings.velocityScales = append(bindings.velocityScales, velocityScale)
+	sign := 1.0
+	if controller.Inverted {
+		sign = -1
+	}
+	bindings.signs = append(bindings.signs, sign)
+	bindings.outputBuffer = make([]float64, len(bindings.outputs))
+	bindings.sensorBuffer = make([]float64, len(bindings.sensors))
+}
+
+func (bindings *Bindings) ReadOutputs() {
+	halsim.GetSimDoubles(bindings.outputs, bindings.outputBuffer)
+	for i, output := range bindings.outputBuffer {
+		*bindings.voltages[i] = bindings.signs[i] * clamp(output, -1, 1) * bindings.BusVoltage
+	}
+}
+
+func (bindings *Bindings) WriteSensors() {
+	for i := range bindings.positions {
+		position := *bindings.positions[i] * bindings.positionScales[i]
+		if bindings.PositionNoise != 0 {
+			position += bindings.Random.NormFloat64() * bindings.PositionNoise
+		}
+		bindings.sensorBuffer[2*i] = bindings.signs[i] * position
+		bindings.sensorBuffer[2*i+1] = bindings.signs[i] * *bindings.velocities[i] * bindings.velocityScales[i]
+	}
+	halsim.SetSimDoubles(bindings.sensors, bindings.sensorBuffer)
+}
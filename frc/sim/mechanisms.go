@@ -0,0 +1,196 @@
+package sim
+
+import "math"
+
+const (
+	// Sub steps per Step call, the models are stiff enough that 20 ms Euler steps overshoot
+	DefaultSubsteps = 10
+)
+
+// Motors driving an inertial load through a gearbox, like a flywheel or an intake roller.
+// Gearing is motor rotations per output rotation and Inertia is in kilogram square meters at the output
+type Gearboxes struct {
+	Motor      DCMotor
+	MotorCount int
+	Substeps   int
+
+	Voltage           []float64
+	Gearing, Inertia  []float64
+	Friction          []float64 // Viscous, newton meters per radian per second
+	Position          []float64 // Radians
+	Velocity, Current []float64 // Current is the total for all motors
+}
+
+func NewGearboxes(count int, motor DCMotor, motorCount int) *Gearboxes {
+	return &Gearboxes{
+		Motor: motor, MotorCount: motorCount, Substeps: DefaultSubsteps,
+		Voltage: make([]float64, count), Gearing: filled(count, 1), Inertia: filled(count, 0.01),
+		Friction: make([]float64, count), Position: make([]float64, count),
+		Velocity: make([]float64, count), Current: make([]float64, count),
+	}
+}
+
+func (gearboxes *Gearboxes) Step(dt float64) {
+	constants := gearboxes.Motor.constants()
+	motors := float64(gearboxes.MotorCount)
+	h := dt / float64(gearboxes.Substeps)
+	for s := 0; s < gearboxes.Substeps; s++ {
+		for i := range gearboxes.Velocity {
+			gearing := gearboxes.Gearing[i]
+			current := constants.current(gearboxes.Voltage[i], gearboxes.Velocity[i]*gearing)
+			torque := motors*constants.kt*current*gearing - gearboxes.Friction[i]*gearboxes.Velocity[i]
+			gearboxes.Velocity[i] += torque / gearboxes.Inertia[i] * h
+			gearboxes.Position[i] += gearboxes.Velocity[i] * h
+			gearboxes.Current[i] = motors * math.Abs(current)
+		}
+	}
+}
+
+// Carriage lifted by a cable on a drum, Position is the height in meters and is kept between 0 and MaxHeight
+type Elevators struct {
+	Motor      DCMotor
+	MotorCount int
+	Substeps   int
+
+	Voltage                     []float64
+	Gearing, Mass, DrumRadius   []float64
+	MaxHeight                   []float64
+	Position, Velocity, Current []float64
+}
+
+func NewElevators(count int, motor DCMotor, motorCount int) *Elevators {
+	return &Elevators{
+		Motor: motor, MotorCount: motorCount, Substeps: DefaultSubsteps,
+		Voltage: make([]float64, count), Gearing: filled(count, 10), Mass: filled(count, 5),
+		DrumRadius: filled(count, 0.02), MaxHeight: filled(count, 1.5), Position: make([]float64, count),
+		Velocity: make([]float64, count), Current: make([]float64, count),
+	}
+}
+
+func (elevators *Elevators) Step(dt float64) {
+	constants := elevators.Motor.constants()
+	motors := float64(elevators.MotorCount)
+	h := dt / float64(elevators.Substeps)
+	for s := 0; s < elevators.Substeps; s++ {
+		for i := range elevators.Velocity {
+			ratio := elevators.Gearing[i] / elevators.DrumRadius[i] // Motor radians per meter
+			current := constants.current(elevators.Voltage[i], elevators.Velocity[i]*ratio)
+			force := motors*constants.kt*current*ratio - elevators.Mass[i]*Gravity
+			velocity := elevators.Velocity[i] + force/elevators.Mass[i]*h
+			position := elevators.Position[i] + velocity*h
+			if position < 0 || position > elevators.MaxHeight[i] {
+				position, velocity = clamp(position, 0, elevators.MaxHeight[i]), 0 // Hard stop
+			}
+			elevators.Position[i], elevators.Velocity[i] = position, velocity
+			elevators.Current[i] = motors * math.Abs(current)
+		}
+	}
+}
+
+// Single jointed arm modeled as a point mass at Length, Position is the angle in radians from horizontal
+type Arms struct {
+	Motor      DCMotor
+	MotorCount int
+	Substeps   int
+
+	Voltage                     []float64
+	Gearing, Mass, Length       []float64
+	MinAngle, MaxAngle          []float64
+	Position, Velocity, Current []float64
+}
+
+func NewArms(count int, motor DCMotor, motorCount int) *Arms {
+	return &Arms{
+		Motor: motor, MotorCount: motorCount, Substeps: DefaultSubsteps,
+		Voltage: make([]float64, count), Gearing: filled(count, 100), Mass: filled(count, 3),
+		Length: filled(count, 0.5), MinAngle: filled(count, -math.Pi/2), MaxAngle: filled(count, math.Pi/2),
+		Position: make([]float64, count), Velocity: make([]float64, count), Current: make([]float64, count),
+	}
+}
+
+func (arms *Arms) Step(dt float64) {
+	constants := arms.Motor.constants()
+	motors := float64(arms.MotorCount)
+	h := dt / float64(arms.Substeps)
+	for s := 0; s < arms.Substeps; s++ {
+		for i := range arms.Velocity {
+			gearing, mass, length := arms.Gearing[i], arms.Mass[i], arms.Length[i]
+			current := constants.current(arms.Voltage[i], arms.Velocity[i]*gearing)
+			torque := motors*constants.kt*current*gearing - mass*Gravity*length*math.Cos(arms.Position[i])
+			velocity := arms.Velocity[i] + torque/(mass*length*length)*h
+			position := arms.Position[i] + velocity*h
+			if position < arms.MinAngle[i] || position > arms.MaxAngle[i] {
+				position, velocity = clamp(position, arms.MinAngle[i], arms.MaxAngle[i]), 0
+			}
+			arms.Position[i], arms.Velocity[i] = position, velocity
+			arms.Current[i] = motors * math.Abs(current)
+		}
+	}
+}
+
+// Tank drive with MotorCount motors per side. Positions and velocities are of the wheels in meters,
+// X, Y and Heading are the field pose with the heading in radians counter clockwise
+type DifferentialDrives struct {
+	Motor      DCMotor
+	MotorCount int
+	Substeps   int
+
+	LeftVoltage, RightVoltage   []float64
+	Gearing, WheelRadius        []float64
+	Mass, Inertia, TrackWidth   []float64
+	Friction                    []float64 // Viscous on each side, newtons per meter per second
+	LeftPosition, RightPosition []float64
+	LeftVelocity, RightVelocity []float64
+	X, Y, Heading               []float64
+	LeftCurrent, RightCurrent   []float64
+}
+
+func NewDifferentialDrives(count int, motor DCMotor, motorCount int) *DifferentialDrives {
+	return &DifferentialDrives{
+		Motor: motor, MotorCount: motorCount, Substeps: DefaultSubsteps,
+		LeftVoltage: make([]float64, count), RightVoltage: make([]float64, count),
+		Gearing: filled(count, 10.71), WheelRadius: filled(count, 0.0762),
+		Mass: filled(count, 60), Inertia: filled(count, 6), TrackWidth: filled(count, 0.6),
+		Friction:     make([]float64, count),
+		LeftPosition: make([]float64, count), RightPosition: make([]float64, count),
+		LeftVelocity: make([]float64, count), RightVelocity: make([]float64, count),
+		X: make([]float64, count), Y: make([]float64, count), Heading: make([]float64, count),
+		LeftCurrent: make([]float64, count), RightCurrent: make([]float64, count),
+	}
+}
+
+func (drives *DifferentialDrives) Step(dt float64) {
+	constants := drives.Motor.constants()
+	motors := float64(drives.MotorCount)
+	h := dt / float64(drives.Substeps)
+	for s := 0; s < drives.Substeps; s++ {
+		for i := range drives.LeftVelocity {
+			ratio := drives.Gearing[i] / drives.WheelRadius[i]
+			halfTrack := drives.TrackWidth[i] / 2
+			leftCurrent := constants.current(drives.LeftVoltage[i], drives.LeftVelocity[i]*ratio)
+			rightCurrent := constants.current(drives.RightVoltage[i], drives.RightVelocity[i]*ratio)
+			leftForce := motors*constants.kt*leftCurrent*ratio - drives.Friction[i]*drives.LeftVelocity[i]
+			rightForce := motors*constants.kt*rightCurrent*ratio - drives.Friction[i]*drives.RightVelocity[i]
+			linear := (drives.LeftVelocity[i] + drives.RightVelocity[i]) / 2
+			angular := (drives.RightVelocity[i] - drives.LeftVelocity[i]) / (2 * halfTrack)
+			linear += (leftForce + rightForce) / drives.Mass[i] * h
+			angular += (rightForce - leftForce) * halfTrack / drives.Inertia[i] * h
+			drives.LeftVelocity[i], drives.RightVelocity[i] = linear-angular*halfTrack, linear+angular*halfTrack
+			drives.LeftPosition[i] += drives.LeftVelocity[i] * h
+			drives.RightPosition[i] += drives.RightVelocity[i] * h
+			drives.Heading[i] += angular * h
+			drives.X[i] += linear * math.Cos(drives.Heading[i]) * h
+			drives.Y[i] += linear * math.Sin(drives.Heading[i]) * h
+			drives.LeftCurrent[i] = motors * math.Abs(leftCurrent)
+			drives.RightCurrent[i] = motors * math.Abs(rightCurrent)
+		}
+	}
+}
+
+func filled(count int, value float64) []float64 {
+	values := make([]float64, count)
+	for i := range values {
+		values[i] = value
+	}
+	return values
+}
@@ -0,0 +1,59 @@
+// Package sim has physics models for simulating mechanisms off the robot.
+// Every model type holds many independent instances as parallel slices and steps all of them in one loop,
+// so large parameter sweeps can run hundreds of robots per core
+package sim
+
+import "math"
+
+const (
+	Gravity = 9.81
+)
+
+func rpm(speed float64) float64 {
+	return speed * 2 * math.Pi / 60
+}
+
+// Brushed or brushless DC motor, FreeSpeed is in radians per second
+type DCMotor struct {
+	NominalVoltage, StallTorque, StallCurrent, FreeCurrent, FreeSpeed float64
+}
+
+var (
+	CIM     = DCMotor{12, 2.42, 133, 2.7, rpm(5310)}
+	MiniCIM = DCMotor{12, 1.41, 89, 3, rpm(5840)}
+	Pro775  = DCMotor{12, 0.71, 134, 0.7, rpm(18730)}
+	NEO     = DCMotor{12, 2.6, 105, 1.8, rpm(5676)}
+)
+
+// Ohms
+func (motor DCMotor) Resistance() float64 {
+	return motor.NominalVoltage / motor.StallCurrent
+}
+
+// Radians per second per volt
+func (motor DCMotor) KV() float64 {
+	return motor.FreeSpeed / (motor.NominalVoltage - motor.Resistance()*motor.FreeCurrent)
+}
+
+// Newton meters per amp
+func (motor DCMotor) KT() float64 {
+	return motor.StallTorque / motor.StallCurrent
+}
+
+// Precomputed constants so the inner loops of the models only multiply
+type motorConstants struct {
+	resistance, kv, kt float64
+}
+
+func (motor DCMotor) constants() motorConstants {
+	return motorConstants{motor.Resistance(), motor.KV(), motor.KT()}
+}
+
+// Current through one motor given its applied voltage and speed in radians per second
+func (constants motorConstants) current(voltage, speed float64) float64 {
+	return (voltage - speed/constants.kv) / constants.resistance
+}
+
+func clamp(value, low, high float64) float64 {
+	return math.Max(low, math.Min(high, value))
+}
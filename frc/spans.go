@@ -0,0 +1,81 @@
+package frc
+
+import (
+	"fmt"
+	"strings"
+	"unsafe"
+)
+
+// A microsecond to about 60 milliseconds, past the longest tick worth telling apart
+var SpanBounds = ExponentialBounds(1e-6, 1.5, 28)
+
+// Times a piece of the tick into a histogram, using the FPGA clock. Create spans once, during init, and use them
+// from the loop thread only:
+//
+//	var armSpan = frc.NewSpan("arm")
+//
+//	func updateArm() {
+//		defer armSpan.Begin().End()
+//		...
+//	}
+//
+// A span measures one thing at a time, so it cannot be nested in itself. While tracing, spans also show up in the trace
+type Span struct {
+	Name      string
+	Histogram *Histogram
+	Last      float64 // Seconds the latest measurement took
+	start     float64
+	trace     unsafe.Pointer
+}
+
+var (
+	spans     []*Span
+	tickSpan  = NewSpan("tick")
+	robotSpan = NewSpan("robotPeriodic")
+	modeSpans = [...]*Span{Disabled: NewSpan(modeNames[Disabled]), Autonomous: NewSpan(modeNames[Autonomous]),
+		Teleop: NewSpan(modeNames[Teleop]), Test: NewSpan(modeNames[Test])}
+	tickEndSpans []*Span
+)
+
+func NewSpan(name string) *Span {
+	span := &Span{Name: name, Histogram: NewHistogram(SpanBounds), trace: traceName(name)}
+	spans = append(spans, span)
+	return span
+}
+
+func (span *Span) Begin() *Span {
+	traceBegin(span.trace)
+	span.start = getFPGATime()
+	return span
+}
+
+func (span *Span) End() {
+	span.Last = getFPGATime() - span.start
+	span.Histogram.Add(span.Last)
+	traceEnd(span.trace)
+}
+
+func (span *Span) lastMillis(*LogRecord) float64 {
+	return span.Last * 1e3
+}
+
+// Every span that ran since the last reset, one line each in microseconds
+func SpanSummary() string {
+	var builder strings.Builder
+	fmt.Fprintf(&builder, "%-24s %8s %8s %8s %8s %8s\n", "span", "n", "mean", "p50", "p99", "max")
+	for _, span := range spans {
+		histogram := span.Histogram
+		if histogram.Total == 0 {
+			continue
+		}
+		fmt.Fprintf(&builder, "%-24s %8d %8.1f %8.1f %8.1f %8.1f\n", span.Name, histogram.Total,
+			histogram.Mean()*1e6, histogram.Quantile(0.5)*1e6, histogram.Quantile(0.99)*1e6, histogram.Max*1e6)
+	}
+	return builder.String()
+}
+
+func ResetSpans() {
+	for _, span := range spans {
+		span.Histogram.Reset()
+	}
+}
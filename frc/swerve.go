@@ -0,0 +1,140 @@
+package frc
+
+import (
+	"go-frc/frc/drive"
+	"go-frc/frc/phoenix"
+	"go-frc/frc/rev"
+)
+
+// A motor of a swerve module, either a Talon or a Spark
+type SwerveMotor struct {
+	Talon *phoenix.Talon
+	Spark *rev.Spark
+	Scale float64 // Sensor units per meter the wheel rolls for a drive motor, per radian the module turns for an azimuth
+}
+
+type SwerveModule struct {
+	X, Y           float64 // Meters forward and left of the center of the robot
+	Drive, Azimuth SwerveMotor
+	AzimuthOffset  float64 // Radians the azimuth sensor reads when the module points forward
+}
+
+// Swerve modules driven by the motor controllers' own loops, velocity for the wheels and position for the azimuths.
+// A tick reads every sensor with one call into each vendor library and sends every setpoint with one more, instead
+// of a call for each motor. Set up the gains with ConfigPID on each motor before driving
+type SwerveDrive struct {
+	Kinematics drive.SwerveKinematics
+	MaxSpeed   float64 // Meters per second, commands that would drive a module faster are scaled down together
+
+	// Module states of the last Drive, in meters per second and unwrapped radians, and the wheel distances in meters
+	Speeds, Angles, Distances []float64
+
+	modules          []SwerveModule
+	current          []float64
+	talons           *phoenix.TalonBatch
+	sparks           *rev.SparkBatch
+	drives, azimuths []swerveSlot
+	unbatched        bool // Crosses into C for each motor instead, so the benchmark can compare the two
+}
+
+// Where a motor is in the batches
+type swerveSlot struct {
+	spark bool
+	index int
+	scale float64
+}
+
+func NewSwerveDrive(maxSpeed float64, modules ...SwerveModule) *SwerveDrive {
+	count := len(modules)
+	swerve := &SwerveDrive{
+		Kinematics: drive.SwerveKinematics{X: make([]float64, count), Y: make([]float64, count)},
+		MaxSpeed:   maxSpeed,
+		Speeds:     make([]float64, count),
+		Angles:     make([]float64, count),
+		Distances:  make([]float64, count),
+		modules:    modules,
+		current:    make([]float64, count),
+		drives:     make([]swerveSlot, count),
+		azimuths:   make([]swerveSlot, count),
+	}
+	var talons []*phoenix.Talon
+	var sparks []*rev.Spark
+	slot := func(motor SwerveMotor) swerveSlot {
+		switch {
+		case motor.Talon != nil:
+			talons = append(talons, motor.Talon)
+			return swerveSlot{false, len(talons) - 1, motor.Scale}
+		case motor.Spark != nil:
+			sparks = append(sparks, motor.Spark)
+			return swerveSlot{true, len(sparks) - 1, motor.Scale}
+		}
+		panic("swerve motor without a Talon or a Spark")
+	}
+	for i, module := range modules {
+		swerve.Kinematics.X[i], swerve.Kinematics.Y[i] = module.X, module.Y
+		swerve.drives[i] = slot(module.Drive)
+		swerve.azimuths[i] = slot(module.Azimuth)
+	}
+	swerve.talons = phoenix.NewTalonBatch(talons...)
+	swerve.sparks = rev.NewSparkBatch(sparks...)
+	return swerve
+}
+
+func (swerve *SwerveDrive) position(slot swerveSlot) float64 {
+	if slot.spark {
+		return swerve.sparks.Positions[slot.index]
+	}
+	return swerve.talons.Positions[slot.index]
+}
+
+// Reads the modules, works out their states for chassis in one pass over them and sends the setpoints
+func (swerve *SwerveDrive) Drive(chassis drive.ChassisSpeeds) {
+	if swerve.unbatched {
+		swerve.talons.ReadPositionsEach()
+		swerve.sparks.ReadPositionsEach()
+	} else {
+		swerve.talons.ReadPositions()
+		swerve.sparks.ReadPositions()
+	}
+	for i, module := range swerve.modules {
+		swerve.current[i] = swerve.position(swerve.azimuths[i])/swerve.azimuths[i].scale - module.AzimuthOffset
+		swerve.Distances[i] = swerve.position(swerve.drives[i]) / swerve.drives[i].scale
+	}
+	swerve.Kinematics.ToModuleStates(chassis, swerve.Speeds, swerve.Angles)
+	drive.DesaturateWheelSpeeds(swerve.Speeds, swerve.MaxSpeed)
+	drive.OptimizeModuleStates(swerve.Speeds, swerve.Angles, swerve.current)
+	for i, module := range swerve.modules {
+		driveSlot, azimuthSlot := swerve.drives[i], swerve.azimuths[i]
+		azimuth := (swerve.Angles[i] + module.AzimuthOffset) * azimuthSlot.scale
+		// Talons count velocity per 100 ms, Sparks per minute
+		if driveSlot.spark {
+			swerve.sparks.Set(driveSlot.index, rev.Velocity, swerve.Speeds[i]*driveSlot.scale*60)
+		} else {
+			swerve.talons.Set(driveSlot.index, phoenix.Velocity, swerve.Speeds[i]*driveSlot.scale/10)
+		}
+		if azimuthSlot.spark {
+			swerve.sparks.Set(azimuthSlot.index, rev.Position, azimuth)
+		} else {
+			swerve.talons.Set(azimuthSlot.index, phoenix.Position, azimuth)
+		}
+	}
+	if swerve.unbatched {
+		swerve.talons.SendEach()
+		swerve.sparks.SendEach()
+	} else {
+		swerve.talons.Send()
+		swerve.sparks.Send()
+	}
+}
+
+// Lets every motor go
+func (swerve *SwerveDrive) Stop() {
+	for i := range swerve.talons.Talons {
+		swerve.talons.Set(i, phoenix.PercentOutput, 0)
+	}
+	for i := range swerve.sparks.Sparks {
+		swerve.sparks.Set(i, rev.DutyCycle, 0)
+	}
+	swerve.talons.Send()
+	swerve.sparks.Send()
+}
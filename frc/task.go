@@ -0,0 +1,55 @@
+package frc
+
+import (
+	"runtime"
+	"sync"
+)
+
+// Work that runs at its own rate on its own thread, such as closing a control loop faster than the loop's 50 Hz
+type Task struct {
+	Name    string
+	lock    sync.Mutex // Held while fn runs
+	stopped bool
+}
+
+// Runs fn every period seconds on a thread of its own, woken by the same kind of timer as the loop. fn gets the
+// seconds since it last ran. It runs alongside the loop, so anything it shares with the loop needs a lock or atomics.
+// While tracing, each run shows up in the trace under the task's name
+func StartTask(name string, period float64, fn func(dt float64)) *Task {
+	task := &Task{Name: name}
+	trace := traceName(name)
+	// Made before returning, so the stepped simulation clock waits for the task from its first step
+	timer := newLoopTimer(period)
+	go func() {
+		runtime.LockOSThread()
+		nameThread(name)
+		// A timerfd timer gives its priority back to the thread that waited on it
+		defer timer.Close()
+		last := getFPGATime()
+		for {
+			if _, ok := timer.Wait(); !ok {
+				return
+			}
+			task.lock.Lock()
+			if task.stopped {
+				task.lock.Unlock()
+				return
+			}
+			traceBegin(trace)
+			now := getFPGATime()
+			fn(now - last)
+			last = now
+			traceEnd(trace)
+			task.lock.Unlock()
+		}
+	}()
+	return task
+}
+
+// Once this returns fn will not run again, it only waits for a run that is under way. The thread ends when it
+// next wakes
+func (task *Task) Stop() {
+	task.lock.Lock()
+	task.stopped = true
+	task.lock.Unlock()
+}
@@ -0,0 +1,45 @@
+package frc
+
+import (
+	"go-frc/frc/datalog"
+	"go-frc/frc/telemetry"
+)
+
+var (
+	telemetryPublisher *telemetry.Publisher
+	telemetryColumns   []func(record *LogRecord) float64
+	telemetryValues    []float64
+	tickRecord         LogRecord // Filled in by logTick, then copied to the data log and telemetry
+)
+
+// Publishes the same signals as the data log to TelemetryAddress, followed by how long each span took in the tick.
+// Spans created after this are not published
+func startTelemetry() error {
+	signals, columns := recordSignals()
+	for _, span := range spans {
+		signals = append(signals, datalog.Signal{Name: span.Name, Units: "ms", Resolution: 1e-3})
+		columns = append(columns, span.lastMillis)
+	}
+	publisher, err := telemetry.NewPublisher(TelemetryAddress, signals, TelemetryRate)
+	if err != nil {
+		return err
+	}
+	telemetryPublisher, telemetryColumns = publisher, columns
+	telemetryValues = make([]float64, len(columns))
+	return nil
+}
+
+// Copies the tick into the publisher's ring, the sending happens on its own goroutine
+func publishTick(record *LogRecord) {
+	if telemetryPublisher == nil {
+		return
+	}
+	for i, column := range telemetryColumns {
+		telemetryValues[i] = column(record)
+	}
+	telemetryPublisher.Publish(record.Time, telemetryValues)
+	// A span that does not run in the next tick is published as taking no time
+	for _, span := range spans {
+		span.Last = 0
+	}
+}
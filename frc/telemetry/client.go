@@ -0,0 +1,146 @@
+package telemetry
+
+import (
+	"encoding/binary"
+	"errors"
+	"go-frc/frc/datalog"
+	"math"
+	"net"
+)
+
+var ErrBadDatagram = errors.New("telemetry: bad datagram")
+
+// Receives what a Publisher sends, for dashboards and for checking the publisher against a loopback address
+type Client struct {
+	Signals []datalog.Signal // Empty until the first schema arrives
+	Lost    uint64           // Data datagrams missing from the sequence
+
+	conn     *net.UDPConn
+	buffer   []byte
+	received bool
+	next     uint64
+}
+
+type Frame struct {
+	Time   float64
+	Values []float64
+}
+
+// Listens on address, such as ":5800" or "127.0.0.1:5800"
+func Listen(address string) (*Client, error) {
+	udpAddress, err := net.ResolveUDPAddr("udp", address)
+	if err != nil {
+		return nil, err
+	}
+	conn, err := net.ListenUDP("udp", udpAddress)
+	if err != nil {
+		return nil, err
+	}
+	return &Client{conn: conn, buffer: make([]byte, 65536)}, nil
+}
+
+// Where the client listens, useful after listening on port 0
+func (client *Client) Address() string {
+	return client.conn.LocalAddr().String()
+}
+
+func (client *Client) Close() error {
+	return client.conn.Close()
+}
+
+// Waits for the next batch of frames. Schema datagrams update Signals and return no frames, and so do data
+// datagrams that arrive before any schema
+func (client *Client) Receive() ([]Frame, error) {
+	n, err := client.conn.Read(client.buffer)
+	if err != nil {
+		return nil, err
+	}
+	datagram := client.buffer[:n]
+	if len(datagram) < len(magic)+1 || string(datagram[:len(magic)]) != magic {
+		return nil, ErrBadDatagram
+	}
+	kind, datagram := datagram[len(magic)], datagram[len(magic)+1:]
+	if kind == kindSchema {
+		return nil, client.readSchema(datagram)
+	}
+	if kind != kindData {
+		return nil, ErrBadDatagram
+	}
+	sequence, datagram, ok := readUvarint(datagram)
+	count, datagram, ok2 := readUvarint(datagram)
+	if !ok || !ok2 {
+		return nil, ErrBadDatagram
+	}
+	if client.received && sequence > client.next {
+		client.Lost += sequence - client.next
+	}
+	client.received, client.next = true, sequence+1
+	if client.Signals == nil {
+		return nil, nil
+	}
+	frames := make([]Frame, 0, count)
+	lastTime := int64(0)
+	last := make([]int64, len(client.Signals))
+	for len(frames) < int(count) {
+		delta, n := binary.Varint(datagram)
+		if n <= 0 {
+			return frames, ErrBadDatagram
+		}
+		datagram = datagram[n:]
+		lastTime += delta
+		frame := Frame{Time: float64(lastTime) * 1e-6, Values: make([]float64, len(client.Signals))}
+		for i := range client.Signals {
+			delta, n := binary.Varint(datagram)
+			if n <= 0 {
+				return frames, ErrBadDatagram
+			}
+			datagram = datagram[n:]
+			last[i] += delta
+			frame.Values[i] = client.Signals[i].Restore(last[i])
+		}
+		frames = append(frames, frame)
+	}
+	return frames, nil
+}
+
+func (client *Client) readSchema(datagram []byte) error {
+	count, datagram, ok := readUvarint(datagram)
+	if !ok {
+		return ErrBadDatagram
+	}
+	signals := make([]datalog.Signal, 0, count)
+	for len(signals) < int(count) {
+		var signal datalog.Signal
+		if signal.Name, datagram, ok = readString(datagram); !ok {
+			return ErrBadDatagram
+		}
+		if signal.Units, datagram, ok = readString(datagram); !ok {
+			return ErrBadDatagram
+		}
+		if len(datagram) < 9 {
+			return ErrBadDatagram
+		}
+		signal.Type = datalog.Type(datagram[0])
+		signal.Resolution = math.Float64frombits(binary.LittleEndian.Uint64(datagram[1:]))
+		datagram = datagram[9:]
+		signals = append(signals, signal)
+	}
+	client.Signals = signals
+	return nil
+}
+
+func readUvarint(buffer []byte) (uint64, []byte, bool) {
+	value, n := binary.Uvarint(buffer)
+	if n <= 0 {
+		return 0, buffer, false
+	}
+	return value, buffer[n:], true
+}
+
+func readString(buffer []byte) (string, []byte, bool) {
+	length, buffer, ok := readUvarint(buffer)
+	if !ok || uint64(len(buffer)) < length {
+		return "", buffer, false
+	}
+	return string(buffer[:length]), buffer[length:], true
+}
@@ -0,0 +1,227 @@
+// Live telemetry over UDP. The loop copies its signals into a small ring once per tick, and a background goroutine
+// sends the newest frames to a dashboard in batches at its own rate. Frames the sender did not get to in time are
+// dropped, never queued, so a slow or missing dashboard costs the loop nothing.
+//
+// Every datagram starts with "FRCT" and a kind byte. A schema datagram, sent once a second, holds the number of
+// signals as a uvarint, then each signal's name and units as uvarint length strings, its type byte and its
+// resolution as a little endian float64. A data datagram holds its sequence number and number of frames as
+// uvarints, then each frame's time in microseconds and its values stored as in the data log, all as zigzag varint
+// deltas from the frame before. The first frame of a datagram is a delta from zero, so every datagram decodes on
+// its own even when others are lost
+package telemetry
+
+import (
+	"encoding/binary"
+	"go-frc/frc/datalog"
+	"math"
+	"net"
+	"sync/atomic"
+	"time"
+)
+
+const (
+	magic       = "FRCT"
+	kindSchema  = 'S'
+	kindData    = 'D'
+	maxDatagram = 1400 // Fits in one Ethernet frame with the IP and UDP headers
+
+	ringFrames = 64
+)
+
+var schemaPeriod = time.Second // How often the schema is repeated for dashboards that start late
+
+// One slot of the ring. The loop makes the sequence odd while it writes the values and even again when done,
+// the sender keeps a copy only if the sequence was the same even number before and after reading it
+type frame struct {
+	sequence uint64
+	time     uint64
+	values   []uint64
+}
+
+type Publisher struct {
+	conn    net.Conn
+	signals []datalog.Signal
+	period  time.Duration
+	frames  [ringFrames]frame
+	head    uint64 // Frames published so far, only changed by the loop
+	sent    uint64
+	dropped uint64
+	body    []byte  // Sender only
+	last    []int64 // Sender only
+	stop    chan struct{}
+	done    chan struct{}
+}
+
+// Sends to address, such as "10.12.34.5:5800", rate times a second. Every call to Publish must pass one value per
+// signal, in the same order
+func NewPublisher(address string, signals []datalog.Signal, rate float64) (*Publisher, error) {
+	conn, err := net.Dial("udp", address)
+	if err != nil {
+		return nil, err
+	}
+	publisher := &Publisher{
+		conn:    conn,
+		signals: append([]datalog.Signal(nil), signals...),
+		period:  time.Duration(float64(time.Second) / rate),
+		last:    make([]int64, len(signals)),
+		stop:    make(chan struct{}),
+		done:    make(chan struct{}),
+	}
+	for i := range publisher.frames {
+		publisher.frames[i].values = make([]uint64, len(signals))
+	}
+	go publisher.run()
+	return publisher, nil
+}
+
+// Copies a frame into the ring, overwriting the oldest one. Loop thread only, it never blocks or allocates
+func (publisher *Publisher) Publish(time float64, values []float64) {
+	head := publisher.head
+	frame := &publisher.frames[head%ringFrames]
+	atomic.StoreUint64(&frame.sequence, 2*head+1)
+	atomic.StoreUint64(&frame.time, math.Float64bits(time))
+	for i, value := range values {
+		atomic.StoreUint64(&frame.values[i], math.Float64bits(value))
+	}
+	atomic.StoreUint64(&frame.sequence, 2*head+2)
+	atomic.StoreUint64(&publisher.head, head+1)
+}
+
+// Datagrams sent so far
+func (publisher *Publisher) Sent() uint64 {
+	return atomic.LoadUint64(&publisher.sent)
+}
+
+// Frames the sender skipped because newer ones had already replaced them
+func (publisher *Publisher) Dropped() uint64 {
+	return atomic.LoadUint64(&publisher.dropped)
+}
+
+func (publisher *Publisher) Close() {
+	close(publisher.stop)
+	<-publisher.done
+	publisher.conn.Close()
+}
+
+func (publisher *Publisher) run() {
+	defer close(publisher.done)
+	ticker := time.NewTicker(publisher.period)
+	defer ticker.Stop()
+	schema := publisher.encodeSchema()
+	lastSchema := time.Time{}
+	next := uint64(0) // Oldest frame not sent yet
+	sequence := uint64(0)
+	datagram := make([]byte, 0, maxDatagram)
+	times := make([]float64, 0, ringFrames)
+	values := make([]float64, ringFrames*len(publisher.signals))
+	for {
+		select {
+		case <-publisher.stop:
+			return
+		case <-ticker.C:
+		}
+		if time.Since(lastSchema) >= schemaPeriod {
+			// A dashboard that is not listening yet makes the write fail, which is expected
+			publisher.conn.Write(schema)
+			lastSchema = time.Now()
+		}
+		// Only the newest frames are sent, half the ring so the loop is unlikely to overwrite one being read
+		head := atomic.LoadUint64(&publisher.head)
+		if head-next > ringFrames/2 {
+			atomic.AddUint64(&publisher.dropped, head-next-ringFrames/2)
+			next = head - ringFrames/2
+		}
+		times = times[:0]
+		for ; next < head; next++ {
+			if publisher.read(next, &times, values[len(times)*len(publisher.signals):]) {
+				continue
+			}
+			atomic.AddUint64(&publisher.dropped, 1)
+		}
+		for start := 0; start < len(times); {
+			datagram, start = publisher.encodeData(datagram[:0], sequence, times, values, start)
+			sequence++
+			if _, err := publisher.conn.Write(datagram); err == nil {
+				atomic.AddUint64(&publisher.sent, 1)
+			}
+		}
+	}
+}
+
+// Copies frame index out of the ring, false if the loop overwrote it in the meantime
+func (publisher *Publisher) read(index uint64, times *[]float64, values []float64) bool {
+	frame := &publisher.frames[index%ringFrames]
+	if atomic.LoadUint64(&frame.sequence) != 2*index+2 {
+		return false
+	}
+	at := math.Float64frombits(atomic.LoadUint64(&frame.time))
+	for i := range publisher.signals {
+		values[i] = math.Float64frombits(atomic.LoadUint64(&frame.values[i]))
+	}
+	if atomic.LoadUint64(&frame.sequence) != 2*index+2 {
+		return false
+	}
+	*times = append(*times, at)
+	return true
+}
+
+func (publisher *Publisher) encodeSchema() []byte {
+	buffer := append([]byte(magic), kindSchema)
+	buffer = appendUvarint(buffer, uint64(len(publisher.signals)))
+	for _, signal := range publisher.signals {
+		buffer = appendString(buffer, signal.Name)
+		buffer = appendString(buffer, signal.Units)
+		buffer = append(buffer, byte(signal.Type), 0, 0, 0, 0, 0, 0, 0, 0)
+		binary.LittleEndian.PutUint64(buffer[len(buffer)-8:], math.Float64bits(signal.Resolution))
+	}
+	return buffer
+}
+
+// Encodes frames from start on until the datagram is full, returns it and the first frame left out
+func (publisher *Publisher) encodeData(datagram []byte, sequence uint64, times, values []float64,
+	start int) ([]byte, int) {
+	body := publisher.body[:0]
+	lastTime := int64(0)
+	for i := range publisher.last {
+		publisher.last[i] = 0
+	}
+	end := start
+	for ; end < len(times); end++ {
+		size := len(body)
+		micros := int64(math.Round(times[end] * 1e6))
+		body = appendVarint(body, micros-lastTime)
+		lastTime = micros
+		row := values[end*len(publisher.signals):]
+		for i := range publisher.signals {
+			stored := publisher.signals[i].Quantize(row[i])
+			body = appendVarint(body, stored-publisher.last[i])
+			publisher.last[i] = stored
+		}
+		// Leaves room for the header, at most 4 bytes of magic, 1 of kind and 2 uvarints
+		if len(body) > maxDatagram-5-2*binary.MaxVarintLen64 && end > start {
+			body = body[:size]
+			break
+		}
+	}
+	publisher.body = body
+	datagram = append(datagram, magic...)
+	datagram = append(datagram, kindData)
+	datagram = appendUvarint(datagram, sequence)
+	datagram = appendUvarint(datagram, uint64(end-start))
+	return append(datagram, body...), end
+}
+
+func appendUvarint(buffer []byte, value uint64) []byte {
+	var scratch [binary.MaxVarintLen64]byte
+	return append(buffer, scratch[:binary.PutUvarint(scratch[:], value)]...)
+}
+
+func appendVarint(buffer []byte, value int64) []byte {
+	var scratch [binary.MaxVarintLen64]byte
+	return append(buffer, scratch[:binary.PutVarint(scratch[:], value)]...)
+}
+
+func appendString(buffer []byte, s string) []byte {
+	buffer = appendUvarint(buffer, uint64(len(s)))
+	return append(buffer, s...)
+}
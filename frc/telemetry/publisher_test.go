@@ -0,0 +1,170 @@
+package telemetry
+
+import (
+	"go-frc/frc/datalog"
+	"math"
+	"testing"
+	"time"
+)
+
+var testSignals = []datalog.Signal{
+	{Name: "output", Resolution: 1e-3},
+	{Name: "position", Units: "m", Resolution: 1e-4},
+	{Name: "mode", Type: datalog.Integer},
+}
+
+func testValues(i int) []float64 {
+	return []float64{float64(i%100) / 100, -0.25 * float64(i), float64(i % 4)}
+}
+
+// A publisher sending to a client on the loopback interface, the client gives up on reads after a few seconds
+func openLoopback(t testing.TB, rate float64) (*Publisher, *Client) {
+	client, err := Listen("127.0.0.1:0")
+	if err != nil {
+		t.Fatal(err)
+	}
+	client.conn.SetReadDeadline(time.Now().Add(5 * time.Second))
+	publisher, err := NewPublisher(client.Address(), testSignals, rate)
+	if err != nil {
+		client.Close()
+		t.Fatal(err)
+	}
+	return publisher, client
+}
+
+// Receives until count frames have arrived
+func receiveFrames(t *testing.T, client *Client, count int) []Frame {
+	var frames []Frame
+	for len(frames) < count {
+		received, err := client.Receive()
+		if err != nil {
+			t.Fatalf("after %d frames: %v", len(frames), err)
+		}
+		frames = append(frames, received...)
+	}
+	return frames
+}
+
+func checkFrame(t *testing.T, frame Frame, i int) {
+	if want := float64(i) * 0.02; math.Abs(frame.Time-want) > 1e-6 {
+		t.Errorf("frame %d: time %g, want %g", i, frame.Time, want)
+	}
+	for j, want := range testValues(i) {
+		if math.Abs(frame.Values[j]-want) > testSignals[j].Resolution/2+1e-12 {
+			t.Errorf("frame %d: %s is %g, want %g", i, testSignals[j].Name, frame.Values[j], want)
+		}
+	}
+}
+
+func TestPublisherToClient(t *testing.T) {
+	publisher, client := openLoopback(t, 20)
+	defer client.Close()
+	defer publisher.Close()
+
+	for i := 0; i < 10; i++ {
+		publisher.Publish(float64(i)*0.02, testValues(i))
+	}
+	frames := receiveFrames(t, client, 10)
+	if len(client.Signals) != len(testSignals) {
+		t.Fatalf("schema has %d signals, want %d", len(client.Signals), len(testSignals))
+	}
+	for i, signal := range client.Signals {
+		if signal != testSignals[i] {
+			t.Errorf("signal %d is %+v, want %+v", i, signal, testSignals[i])
+		}
+	}
+	if len(frames) != 10 {
+		t.Fatalf("got %d frames, want 10", len(frames))
+	}
+	for i, frame := range frames {
+		checkFrame(t, frame, i)
+	}
+	if publisher.Dropped() != 0 || client.Lost != 0 {
+		t.Errorf("dropped %d and lost %d, want none", publisher.Dropped(), client.Lost)
+	}
+}
+
+// More frames than the sender keeps between two sends, only the newest half ring is sent and the rest counted
+func TestPublisherDropsOldFrames(t *testing.T) {
+	publisher, client := openLoopback(t, 10)
+	defer client.Close()
+	defer publisher.Close()
+
+	const count = 100
+	for i := 0; i < count; i++ {
+		publisher.Publish(float64(i)*0.02, testValues(i))
+	}
+	frames := receiveFrames(t, client, ringFrames/2)
+	if len(frames) != ringFrames/2 {
+		t.Fatalf("got %d frames, want %d", len(frames), ringFrames/2)
+	}
+	for i, frame := range frames {
+		checkFrame(t, frame, count-ringFrames/2+i)
+	}
+	if dropped := publisher.Dropped(); dropped != count-ringFrames/2 {
+		t.Errorf("dropped %d, want %d", dropped, count-ringFrames/2)
+	}
+}
+
+// A dashboard that starts after the schema went out decodes nothing until the schema is sent again
+func TestPublisherResendsSchema(t *testing.T) {
+	defer func(period time.Duration) { schemaPeriod = period }(schemaPeriod)
+	schemaPeriod = 100 * time.Millisecond
+	publisher, client := openLoopback(t, 50)
+	defer client.Close()
+
+	stop, stopped := make(chan struct{}), make(chan struct{})
+	go func() {
+		defer close(stopped)
+		for i := 0; ; i++ {
+			select {
+			case <-stop:
+				return
+			case <-time.After(5 * time.Millisecond):
+			}
+			publisher.Publish(float64(i)*0.02, testValues(i))
+		}
+	}()
+	defer func() {
+		close(stop)
+		<-stopped
+		publisher.Close()
+	}()
+
+	receiveFrames(t, client, 1)
+	client.Signals = nil
+	start := time.Now()
+	for client.Signals == nil {
+		if frames, err := client.Receive(); err != nil {
+			t.Fatal(err)
+		} else if len(frames) > 0 {
+			t.Fatal("decoded frames without a schema")
+		}
+	}
+	if elapsed := time.Since(start); elapsed > 3*schemaPeriod {
+		t.Errorf("schema took %v to come again, want about %v", elapsed, schemaPeriod)
+	}
+	receiveFrames(t, client, 1)
+}
+
+// What the loop pays to publish a tick, with a client on the loopback interface reading everything sent
+func BenchmarkPublish(b *testing.B) {
+	publisher, client := openLoopback(b, 50)
+	defer client.Close()
+	defer publisher.Close()
+	client.conn.SetReadDeadline(time.Time{})
+	go func() {
+		for {
+			if _, err := client.Receive(); err != nil && err != ErrBadDatagram {
+				return
+			}
+		}
+	}()
+	values := testValues(0)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		values[0] = float64(i&255) / 255
+		publisher.Publish(float64(i)*0.02, values)
+	}
+}
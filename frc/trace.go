@@ -0,0 +1,216 @@
+package frc
+
+/*
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "trace.h"
+
+#define TRACE_CAPACITY 65536
+
+typedef struct {
+	int64_t time; // CLOCK_MONOTONIC nanoseconds
+	const char* name;
+	int32_t thread;
+	char phase;
+} TraceEvent;
+
+static TraceEvent traceRing[TRACE_CAPACITY];
+static uint64_t traceHead;
+static __thread int32_t traceThread;
+
+// Any thread can record, each takes its own slot with one atomic add. Once the ring is full the oldest events are
+// overwritten
+static void traceEvent(const char* name, char phase) {
+	if (!traceThread) traceThread = syscall(SYS_gettid);
+	uint64_t index = __atomic_fetch_add(&traceHead, 1, __ATOMIC_RELAXED);
+	TraceEvent* event = &traceRing[index % TRACE_CAPACITY];
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	event->time = (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+	event->name = name;
+	event->thread = traceThread;
+	event->phase = phase;
+}
+
+static TraceHook traceHook() {
+	return traceEvent;
+}
+
+// Copies the newest events out oldest first, returns how many
+static int copyTrace(TraceEvent* out) {
+	uint64_t head = __atomic_load_n(&traceHead, __ATOMIC_ACQUIRE);
+	uint64_t start = head > TRACE_CAPACITY ? head - TRACE_CAPACITY : 0;
+	for (uint64_t i = start; i < head; i++) {
+		out[i - start] = traceRing[i % TRACE_CAPACITY];
+	}
+	return head - start;
+}
+
+static void nameThread(const char* name) {
+	prctl(PR_SET_NAME, name, 0, 0, 0);
+}
+*/
+import "C"
+import (
+	"bufio"
+	"fmt"
+	"go-frc/frc/phoenix"
+	"go-frc/frc/rev"
+	"io"
+	"io/ioutil"
+	"os"
+	"strconv"
+	"strings"
+	"sync/atomic"
+	"unsafe"
+)
+
+// Where a Chrome trace of the latest ticks is written, for viewing in Perfetto or chrome://tracing. It is written
+// each time the robot is disabled after being enabled and when the loop ends. Empty leaves tracing off
+var TracePath = ""
+
+var (
+	// Checked before recording anything, so tracing costs the loop one branch while it is off. Any thread reads it
+	tracing int32
+	// Holds the buffer the ring is copied into while no copy is being written out. StartTrace makes it, so the
+	// tick that disables the robot does not allocate one
+	traceBuffers chan traceSnapshot
+)
+
+// Records ticks, spans, vendor library calls and background work until StopTrace. The ring keeps the newest
+// 65536 events, a few seconds of a busy robot. Call it and StopTrace from the loop thread or before Start
+func StartTrace() {
+	if traceBuffers == nil {
+		traceBuffers = make(chan traceSnapshot, 1)
+		traceBuffers <- make(traceSnapshot, C.TRACE_CAPACITY)
+	}
+	atomic.StoreInt32(&tracing, 1)
+	phoenix.SetTraceHook(unsafe.Pointer(C.traceHook()))
+	rev.SetTraceHook(unsafe.Pointer(C.traceHook()))
+}
+
+func StopTrace() {
+	atomic.StoreInt32(&tracing, 0)
+	phoenix.SetTraceHook(nil)
+	rev.SetTraceHook(nil)
+}
+
+// Names stay allocated, they are only made once for each span or worker
+func traceName(name string) unsafe.Pointer {
+	return unsafe.Pointer(C.CString(name))
+}
+
+func isTracing() bool {
+	return atomic.LoadInt32(&tracing) != 0
+}
+
+func traceBegin(name unsafe.Pointer) {
+	if isTracing() {
+		C.traceEvent((*C.char)(name), 'B')
+	}
+}
+
+func traceEnd(name unsafe.Pointer) {
+	if isTracing() {
+		C.traceEvent((*C.char)(name), 'E')
+	}
+}
+
+// Names the calling thread in traces and in top, for goroutines locked to their thread
+func nameThread(name string) {
+	cname := C.CString(name)
+	C.nameThread(cname)
+	C.free(unsafe.Pointer(cname))
+}
+
+// The recorded events, copied so the loop can carry on while they are written out
+type traceSnapshot []C.TraceEvent
+
+// Copies the ring into events, which must have room for all of it
+func snapshotTrace(events traceSnapshot) traceSnapshot {
+	return events[:C.copyTrace(&events[0])]
+}
+
+// Writes the events in the Chrome trace event format, with times in microseconds from the first event and every
+// thread named after what the kernel calls it, such as the loop, Phoenix's threads and the data log writer
+func (events traceSnapshot) write(w io.Writer) error {
+	writer := bufio.NewWriter(w)
+	writer.WriteString(`{"displayTimeUnit":"ms","traceEvents":[`)
+	names := make(map[*C.char]string)
+	threads := make(map[C.int32_t]bool)
+	var line []byte
+	for i := range events {
+		event := &events[i]
+		name, ok := names[event.name]
+		if !ok {
+			name = strconv.Quote(C.GoString(event.name))
+			names[event.name] = name
+		}
+		threads[event.thread] = true
+		if i > 0 {
+			writer.WriteByte(',')
+		}
+		line = append(line[:0], `{"name":`...)
+		line = append(line, name...)
+		line = append(line, `,"ph":"`...)
+		line = append(line, byte(event.phase))
+		line = append(line, `","ts":`...)
+		line = strconv.AppendFloat(line, float64(event.time-events[0].time)*1e-3, 'f', 3, 64)
+		line = append(line, `,"pid":1,"tid":`...)
+		line = strconv.AppendInt(line, int64(event.thread), 10)
+		writer.Write(append(line, '}', '\n'))
+	}
+	for thread := range threads {
+		name := fmt.Sprintf("thread %d", thread)
+		if comm, err := ioutil.ReadFile(fmt.Sprintf("/proc/self/task/%d/comm", thread)); err == nil {
+			name = strings.TrimSpace(string(comm))
+		}
+		fmt.Fprintf(writer, `,{"name":"thread_name","ph":"M","pid":1,"tid":%d,"args":{"name":%q}}`+"\n",
+			thread, name)
+	}
+	writer.WriteString("]}\n")
+	return writer.Flush()
+}
+
+// Writes everything recorded so far to w
+func WriteTrace(w io.Writer) error {
+	return snapshotTrace(make(traceSnapshot, C.TRACE_CAPACITY)).write(w)
+}
+
+// Copies the ring into the trace buffer and writes it to TracePath on a goroutine of its own. While the last copy is
+// still being written this one is skipped
+func writeTraceInBackground() {
+	select {
+	case events := <-traceBuffers:
+		go func() {
+			writeTraceFile(snapshotTrace(events))
+			traceBuffers <- events
+		}()
+	default:
+	}
+}
+
+// Writes the trace to TracePath, once the last copy is written
+func writeTraceNow() {
+	events := <-traceBuffers
+	writeTraceFile(snapshotTrace(events))
+	traceBuffers <- events
+}
+
+func writeTraceFile(events traceSnapshot) {
+	file, err := os.Create(TracePath)
+	if err == nil {
+		err = events.write(file)
+		if closeErr := file.Close(); err == nil {
+			err = closeErr
+		}
+	}
+	if err != nil {
+		fmt.Println(err)
+	}
+}